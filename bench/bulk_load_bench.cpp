@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "order_book.h"
+
+// range(0) orders per side spread over 100 levels of each side, in priority order
+static std::vector<RestingOrder> resting_orders(Order::Type type, size_t count)
+{
+    std::vector<RestingOrder> orders;
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto offset = static_cast<Order::PriceType>(i * 100 / count);
+        orders.push_back(RestingOrder{type == Order::Type::Ask ? 1001 + offset : 1000 - offset,
+                                      static_cast<Order::QuantityType>(1 + i % 10)});
+    }
+    return orders;
+}
+
+// Seed the book by add_order for each order
+static void BM_SeedBookAddOrder(benchmark::State &state)
+{
+    auto asks = resting_orders(Order::Type::Ask, static_cast<size_t>(state.range(0)));
+    auto bids = resting_orders(Order::Type::Bid, static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        BasicOrderBook<NullListener> order_book;
+        for (const auto &order : asks)
+            order_book.add_order(Order::Type::Ask, order.price, order.quantity);
+        for (const auto &order : bids)
+            order_book.add_order(Order::Type::Bid, order.price, order.quantity);
+        benchmark::DoNotOptimize(order_book.level_count(Order::Type::Ask));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_SeedBookAddOrder)->Arg(1000)->Arg(100000);
+
+// Seed the book by one load_orders
+static void BM_SeedBookLoadOrders(benchmark::State &state)
+{
+    auto asks = resting_orders(Order::Type::Ask, static_cast<size_t>(state.range(0)));
+    auto bids = resting_orders(Order::Type::Bid, static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        BasicOrderBook<NullListener> order_book;
+        order_book.load_orders(asks, bids);
+        benchmark::DoNotOptimize(order_book.level_count(Order::Type::Ask));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_SeedBookLoadOrders)->Arg(1000)->Arg(100000);
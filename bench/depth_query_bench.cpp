@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "depth_query.h"
+#include "order_book.h"
+
+// 1000 ask levels from 1001 with 1 to 50 orders of quantity 10 each
+static void fill_asks(BasicOrderBook<NullListener> &order_book)
+{
+    for (int level = 0; level < 1000; ++level)
+    {
+        for (int i = 0; i <= level % 50; ++i)
+            order_book.add_order(Order::Type::Ask, 1001 + level, 10);
+    }
+}
+
+// quantities of routing queries, most of them are filled within the first levels
+static std::vector<uint64_t> query_quantities()
+{
+    std::vector<uint64_t> quantities;
+    for (uint64_t quantity = 10; quantity < 200000; quantity = quantity * 5 / 4 + 1)
+        quantities.push_back(quantity);
+    return quantities;
+}
+
+// Price to fill each quantity by walking levels from depth()
+static void BM_FillByDepthWalk(benchmark::State &state)
+{
+    BasicOrderBook<NullListener> order_book;
+    fill_asks(order_book);
+    auto quantities = query_quantities();
+    std::vector<BookLevel> levels(1000);
+    for (auto _ : state)
+    {
+        for (auto quantity : quantities)
+        {
+            auto count = order_book.depth(Order::Type::Ask, levels);
+            uint64_t filled = 0;
+            int64_t notional = 0;
+            for (size_t i = 0; i < count && filled < quantity; ++i)
+            {
+                auto taken = std::min<uint64_t>(levels[i].quantity, quantity - filled);
+                filled += taken;
+                notional += static_cast<int64_t>(taken) * levels[i].price;
+            }
+            benchmark::DoNotOptimize(notional);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(quantities.size()));
+}
+BENCHMARK(BM_FillByDepthWalk);
+
+// The same queries answered by DepthQuery updated once, range(0) is DepthQuery::SimdLevel
+static void BM_FillByDepthQuery(benchmark::State &state)
+{
+    BasicOrderBook<NullListener> order_book;
+    fill_asks(order_book);
+    auto quantities = query_quantities();
+    DepthQuery query(1000, static_cast<DepthQuery::SimdLevel>(state.range(0)));
+    query.update(order_book);
+    for (auto _ : state)
+    {
+        for (auto quantity : quantities)
+            benchmark::DoNotOptimize(query.fill(Order::Type::Ask, quantity));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(quantities.size()));
+    if (static_cast<int64_t>(query.simd_level()) != state.range(0))
+        state.SetLabel("instruction set unsupported");
+}
+BENCHMARK(BM_FillByDepthQuery)->DenseRange(0, 2);
+
+// Cumulative quantity within 0 to 63 ticks of the best price, range(0) is DepthQuery::SimdLevel
+static void BM_QuantityWithin(benchmark::State &state)
+{
+    BasicOrderBook<NullListener> order_book;
+    fill_asks(order_book);
+    DepthQuery query(1000, static_cast<DepthQuery::SimdLevel>(state.range(0)));
+    query.update(order_book);
+    for (auto _ : state)
+    {
+        for (Order::PriceType distance = 0; distance < 64; ++distance)
+            benchmark::DoNotOptimize(query.quantity_within(Order::Type::Ask, distance));
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+    if (static_cast<int64_t>(query.simd_level()) != state.range(0))
+        state.SetLabel("instruction set unsupported");
+}
+BENCHMARK(BM_QuantityWithin)->DenseRange(0, 2);
+
+// Copy of 1000 levels of each side by update
+static void BM_DepthQueryUpdate(benchmark::State &state)
+{
+    BasicOrderBook<NullListener> order_book;
+    fill_asks(order_book);
+    DepthQuery query(1000);
+    for (auto _ : state)
+        query.update(order_book);
+    state.SetItemsProcessed(state.iterations() * 1000);
+}
+BENCHMARK(BM_DepthQueryUpdate);
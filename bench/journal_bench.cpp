@@ -0,0 +1,52 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <unistd.h>
+#include <vector>
+
+#include "journal.h"
+
+// Journal of adds around the middle of price band with every third request canceling live order
+static std::string write_journal(size_t request_count)
+{
+    std::string path = "/tmp/order_book_bench.journal";
+    BasicOrderBook<NullListener> order_book(PriceBand{900, 1100, 1});
+    order_book.set_id_prefix(1);
+    JournalWriter journal(path, order_book, 0);
+    std::mt19937 random(1);
+    std::vector<Order::IdType> ids;
+    OrderResult result;
+    for (size_t i = 0; i < request_count; ++i)
+    {
+        OrderRequest request;
+        if (i % 3 == 0 && !ids.empty())
+        {
+            auto pos = random() % ids.size();
+            request = OrderRequest::cancel(ids[pos]);
+            ids[pos] = ids.back();
+            ids.pop_back();
+        }
+        else
+        {
+            request = OrderRequest::add(random() % 2 ? Order::Type::Ask : Order::Type::Bid,
+                                        static_cast<Order::PriceType>(980 + random() % 40), 1 + random() % 10);
+        }
+        add_orders_journaled(order_book, journal, Span<const OrderRequest>(&request, 1), Span<OrderResult>(&result, 1));
+        if (result.status == OrderResult::Status::Rested && request.action == OrderRequest::Action::Add)
+            ids.push_back(result.id);
+    }
+    return path;
+}
+
+// Rebuild the book from journal with range(0) requests
+static void BM_ReplayJournal(benchmark::State &state)
+{
+    auto path = write_journal(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        BasicOrderBook<NullListener> order_book(PriceBand{900, 1100, 1});
+        benchmark::DoNotOptimize(replay_journal(path, order_book));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    unlink(path.c_str());
+}
+BENCHMARK(BM_ReplayJournal)->Arg(1000000)->Unit(benchmark::kMillisecond);
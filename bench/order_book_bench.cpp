@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include "order_book.h"
+
+using Book = BasicOrderBook<NullListener>;
+
+namespace
+{
+const size_t batch_size = 1000; // orders per iteration of add and cancel benchmarks
+
+// levels of each side around 1000 with orders_per_level orders of quantity 1..10,
+// asks start from 1001 and bids from 1000
+void fill_book(Book &order_book, int levels, int orders_per_level, std::vector<Order::IdType> *ids = nullptr)
+{
+    for (int level = 0; level < levels; ++level)
+    {
+        for (int i = 0; i < orders_per_level; ++i)
+        {
+            auto quantity = static_cast<Order::QuantityType>(1 + (level + i) % 10);
+            auto ask_id = order_book.add_order(Order::Type::Ask, 1001 + level, quantity);
+            auto bid_id = order_book.add_order(Order::Type::Bid, 1000 - level, quantity);
+            if (ids != nullptr)
+            {
+                ids->push_back(ask_id);
+                ids->push_back(bid_id);
+            }
+        }
+    }
+}
+} // namespace
+
+// Add of passive orders to random levels of the book with range(0) levels of each side.
+// Added orders are canceled outside of timing after each batch.
+static void BM_AddOrderNoCross(benchmark::State &state)
+{
+    auto levels = static_cast<int>(state.range(0));
+    Book order_book;
+    fill_book(order_book, levels, 1);
+    std::mt19937 random(1);
+    std::vector<Order::IdType> ids;
+    ids.reserve(batch_size);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < batch_size; ++i)
+        {
+            auto offset = static_cast<Order::PriceType>(random() % levels);
+            ids.push_back(i % 2 ? order_book.add_order(Order::Type::Ask, 1001 + offset, 1)
+                                : order_book.add_order(Order::Type::Bid, 1000 - offset, 1));
+        }
+        state.PauseTiming();
+        for (auto id : ids)
+            order_book.cancel_order(id);
+        ids.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_AddOrderNoCross)->Arg(10)->Arg(1000);
+
+// Bid which executes all range(0) ask levels of one order each and rests on the last price.
+// Levels are restored outside of timing.
+static void BM_SweepLevels(benchmark::State &state)
+{
+    auto levels = static_cast<int>(state.range(0));
+    Book order_book;
+    fill_book(order_book, levels, 1);
+    for (auto _ : state)
+    {
+        auto id = order_book.add_order(Order::Type::Bid, 1000 + levels, 11 * levels);
+        state.PauseTiming();
+        order_book.cancel_order(id);
+        for (int level = 0; level < levels; ++level)
+            order_book.add_order(Order::Type::Ask, 1001 + level, static_cast<Order::QuantityType>(1 + level % 10));
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * levels);
+}
+BENCHMARK(BM_SweepLevels)->Arg(1)->Arg(10)->Arg(100);
+
+// Cancel of random orders of the book with range(0) orders on each of 100 levels of each side.
+// Canceled orders are added back outside of timing after each batch.
+static void BM_CancelDeepBook(benchmark::State &state)
+{
+    Book order_book;
+    std::vector<Order::IdType> ids;
+    fill_book(order_book, 100, static_cast<int>(state.range(0)), &ids);
+    std::mt19937 random(2);
+    std::vector<Order> canceled;
+    canceled.reserve(batch_size);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        canceled.clear();
+        for (size_t i = 0; i < batch_size; ++i) // first batch_size ids become random distinct orders
+        {
+            std::swap(ids[i], ids[i + random() % (ids.size() - i)]);
+            canceled.push_back(order_book.get_order(ids[i]));
+        }
+        state.ResumeTiming();
+        for (size_t i = 0; i < batch_size; ++i)
+            order_book.cancel_order(ids[i]);
+        state.PauseTiming();
+        for (size_t i = 0; i < batch_size; ++i)
+            ids[i] = order_book.add_order(canceled[i].type(), canceled[i].price(), canceled[i].quantity());
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_CancelDeepBook)->Arg(10)->Arg(1000);
+
+// Lookup of random resting order of the book with range(0) orders on each of 100 levels of each side
+static void BM_GetOrder(benchmark::State &state)
+{
+    Book order_book;
+    std::vector<Order::IdType> ids;
+    fill_book(order_book, 100, static_cast<int>(state.range(0)), &ids);
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(3));
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(order_book.get_order(ids[i]));
+        if (++i == ids.size())
+            i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetOrder)->Arg(10)->Arg(1000);
+
+// JSON output of the book with range(0) levels of each side with 4 orders on each level
+template <typename Output>
+static void BM_Json(benchmark::State &state, Output output)
+{
+    Book order_book;
+    fill_book(order_book, static_cast<int>(state.range(0)), 4);
+    order_book.add_order(Order::Type::Bid, 1001, 1); // last trade
+    size_t bytes = 0;
+    for (auto _ : state)
+    {
+        auto json = output(order_book);
+        bytes += json.size();
+        benchmark::DoNotOptimize(json);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK_CAPTURE(BM_Json, orderbook_info, [](const Book &book) { return book.orderbook_info_json(); })
+    ->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK_CAPTURE(BM_Json, market_data_1, [](const Book &book) { return book.market_data_1_json(); })
+    ->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK_CAPTURE(BM_Json, market_data_2, [](const Book &book) { return book.market_data_2_json(); })
+    ->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+// Passive add and cancel of the book with 100 levels of each side, with and without instrumentation
+template <typename Instrumentation>
+static void BM_AddCancel(benchmark::State &state)
+{
+    BasicOrderBook<NullListener, Instrumentation> order_book;
+    for (int level = 0; level < 100; ++level)
+    {
+        order_book.add_order(Order::Type::Ask, 1001 + level, 1);
+        order_book.add_order(Order::Type::Bid, 1000 - level, 1);
+    }
+    Order::PriceType offset = 0;
+    for (auto _ : state)
+    {
+        order_book.cancel_order(order_book.add_order(Order::Type::Bid, 1000 - offset, 1));
+        offset = offset == 99 ? 0 : offset + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_AddCancel, NoInstrumentation);
+BENCHMARK_TEMPLATE(BM_AddCancel, BookInstrumentation);
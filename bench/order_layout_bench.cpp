@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "order_book.h"
+
+namespace
+{
+// Hardware cache miss counter of the calling thread, unavailable in some virtual machines and containers
+class CacheMissCounter
+{
+public:
+    CacheMissCounter()
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        _fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    ~CacheMissCounter()
+    {
+        if (_fd >= 0)
+            close(_fd);
+    }
+    bool available() const { return _fd >= 0; }
+    uint64_t read_count() const
+    {
+        uint64_t count = 0;
+        if (_fd >= 0 && read(_fd, &count, sizeof(count)) != sizeof(count))
+            count = 0;
+        return count;
+    }
+
+private:
+    int _fd = -1;
+};
+
+const int levels = 1000;
+const int orders_per_level = 1000;
+} // namespace
+
+// Bid executes all orders of the best ask level of the book with 1M resting orders. Orders are placed
+// round-robin over levels, so neighbours in a queue are not neighbours in memory, as in real books.
+// Executed level is restored outside of timing.
+static void BM_MatchDeepBook(benchmark::State &state)
+{
+    BasicOrderBook<NullListener> order_book;
+    for (int i = 0; i < orders_per_level; ++i)
+    {
+        for (int level = 0; level < levels; ++level)
+            order_book.add_order(Order::Type::Ask, 1001 + level, 10);
+    }
+    CacheMissCounter counter;
+    uint64_t misses = 0;
+    for (auto _ : state)
+    {
+        auto before = counter.read_count();
+        order_book.add_order(Order::Type::Bid, 1001, 10 * orders_per_level);
+        misses += counter.read_count() - before;
+        state.PauseTiming();
+        for (int i = 0; i < orders_per_level; ++i)
+            order_book.add_order(Order::Type::Ask, 1001, 10);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * orders_per_level);
+    if (counter.available())
+        state.counters["cache_misses_per_match"] =
+            benchmark::Counter(static_cast<double>(misses) / orders_per_level, benchmark::Counter::kAvgIterations);
+    else
+        state.SetLabel("cache miss counter unavailable");
+}
+BENCHMARK(BM_MatchDeepBook);
@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+#include <limits>
+
+#include "allocation_counter.h"
+#include "order_book.h"
+
+// Incoming bid executes part of the first resting ask of the level with range(0) orders.
+// Resting order is shrunk in place, so the book makes no allocations per fill.
+static void BM_PartialFill(benchmark::State &state)
+{
+    OrderBook order_book;
+    for (auto i = 0; i < state.range(0); ++i)
+        order_book.add_order(Order::Type::Ask, 1000, std::numeric_limits<Order::QuantityType>::max());
+    auto allocations = allocation_count();
+    for (auto _ : state)
+        order_book.add_order(Order::Type::Bid, 1000, 1);
+    state.counters["allocs_per_fill"] = benchmark::Counter(allocation_count() - allocations,
+                                                           benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_PartialFill)->Arg(1)->Arg(1000);
+
+// The same with executed order callback
+static void BM_PartialFillCallback(benchmark::State &state)
+{
+    Order::QuantityType executed_quantity = 0;
+    OrderBook order_book([&executed_quantity](Order order) { executed_quantity += order.quantity(); });
+    for (auto i = 0; i < state.range(0); ++i)
+        order_book.add_order(Order::Type::Ask, 1000, std::numeric_limits<Order::QuantityType>::max());
+    auto allocations = allocation_count();
+    for (auto _ : state)
+        order_book.add_order(Order::Type::Bid, 1000, 1);
+    benchmark::DoNotOptimize(executed_quantity);
+    state.counters["allocs_per_fill"] = benchmark::Counter(allocation_count() - allocations,
+                                                           benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_PartialFillCallback)->Arg(1)->Arg(1000);
+
+struct ExecutedQuantityListener : NullListener
+{
+    void on_execute(const Order &order) { executed_quantity += order.quantity(); }
+    Order::QuantityType executed_quantity = 0;
+};
+
+// The same with listener known at compile time
+static void BM_PartialFillListener(benchmark::State &state)
+{
+    BasicOrderBook<ExecutedQuantityListener> order_book;
+    for (auto i = 0; i < state.range(0); ++i)
+        order_book.add_order(Order::Type::Ask, 1000, std::numeric_limits<Order::QuantityType>::max());
+    auto allocations = allocation_count();
+    for (auto _ : state)
+        order_book.add_order(Order::Type::Bid, 1000, 1);
+    benchmark::DoNotOptimize(order_book.listener().executed_quantity);
+    state.counters["allocs_per_fill"] = benchmark::Counter(allocation_count() - allocations,
+                                                           benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_PartialFillListener)->Arg(1)->Arg(1000);
@@ -0,0 +1,299 @@
+#pragma once
+#include <algorithm>
+#include <utility>
+
+#include "book_instrumentation.hpp"
+#include "book_listener.hpp"
+#include "order_book_base.h"
+#include "order_request.hpp"
+#include "span.hpp"
+
+/// @brief Execution rules of incoming order of given type
+template <Order::Type Type>
+struct OrderSide;
+
+template <>
+struct OrderSide<Order::Type::Bid>
+{
+    static constexpr Order::Type opposite = Order::Type::Ask;
+    // bid executes against asks with lower or equal price
+    static bool can_execute(Order::PriceType price_order_in_queue, Order::PriceType price_order_come)
+    {
+        return price_order_in_queue <= price_order_come;
+    }
+};
+
+template <>
+struct OrderSide<Order::Type::Ask>
+{
+    static constexpr Order::Type opposite = Order::Type::Bid;
+    // ask executes against bids with higher or equal price
+    static bool can_execute(Order::PriceType price_order_in_queue, Order::PriceType price_order_come)
+    {
+        return price_order_in_queue >= price_order_come;
+    }
+};
+
+/// @brief Order book which reports events to Listener known at compile time,
+/// so notification calls are inlined into matching loop.
+///
+/// Listener has to provide on_add, on_execute, on_cancel, on_modify and on_trade methods of NullListener.
+/// Instrumentation collects counters and timings of book operations, see BookInstrumentation.
+template <typename Listener, typename Instrumentation = NoInstrumentation>
+class BasicOrderBook : public OrderBookBase
+{
+public:
+    /// @brief Creates BasicOrderBook.
+    ///
+    /// @param listener receiver of book events
+    /// @param memory capacity of preallocated storage and memory resource it is taken from.
+    explicit BasicOrderBook(Listener listener = Listener(), const BookMemory &memory = BookMemory())
+        : OrderBookBase(memory), _listener(std::move(listener)) {}
+
+    /// @brief Creates BasicOrderBook with dense price levels for bounded price range.
+    ///
+    /// @param band min and max price and tick size of the book. Orders with other prices are rejected.
+    /// @param listener receiver of book events
+    /// @param memory capacity of preallocated storage and memory resource it is taken from.
+    BasicOrderBook(const PriceBand &band, Listener listener = Listener(), const BookMemory &memory = BookMemory())
+        : OrderBookBase(band, memory), _listener(std::move(listener)) {}
+
+    /// @brief Add order to OrderBook.
+    ///
+    /// @param type the Order type. Can be either Order::Type::Bid, or Order::Type::Ask
+    /// @param price Order price
+    /// @param quantity Order quantity
+    ///
+    /// Book created with PriceBand throws OutOfBandException if price is out of band.
+    Order::IdType add_order(Order::Type type, Order::PriceType price, Order::QuantityType quantity)
+    {
+        check_price(price);
+        auto order = make_order(type, price, quantity);
+        execute_and_place(order);
+        assert(check_consistency());
+        return order.id();
+    }
+
+    /// @brief Cancel order. Can throw NotFoundException
+    ///
+    /// @param id order id
+    void cancel_order(Order::IdType id)
+    {
+        cancel(find_order(id));
+        assert(check_consistency());
+    }
+
+    /// @brief Change price and quantity of resting order keeping its id. Can throw NotFoundException
+    /// and OutOfBandException.
+    ///
+    /// Decrease of quantity keeps order place in the queue. Otherwise order moves to the end of the queue
+    /// of new price and can be executed at once if new price allows. Zero quantity cancels the order.
+    ///
+    /// @param id order id
+    /// @param price new order price
+    /// @param quantity new order quantity
+    void modify_order(Order::IdType id, Order::PriceType price, Order::QuantityType quantity)
+    {
+        auto node_index = find_order(id);
+        check_price(price);
+        modify(node_index, price, quantity);
+        assert(check_consistency());
+    }
+
+    /// @brief Process batch of add, cancel and modify requests in their order.
+    ///
+    /// Errors are reported in results instead of exceptions.
+    ///
+    /// @param requests operations to perform
+    /// @param results outcome of each request, the same size as requests
+    /// @return number of processed requests, the least of requests and results sizes
+    size_t add_orders(Span<const OrderRequest> requests, Span<OrderResult> results)
+    {
+        auto count = std::min(requests.size(), results.size());
+        for (size_t i = 0; i < count; ++i)
+            results[i] = process(requests[i]);
+        assert(check_consistency());
+        return count;
+    }
+
+    Listener &listener() { return _listener; }
+    const Listener &listener() const { return _listener; }
+
+    /// @brief counters and histograms collected by instrumentation, zeros without it
+    BookStats stats() const { return _instrumentation.stats(); }
+    const Instrumentation &instrumentation() const { return _instrumentation; }
+
+private:
+    Listener _listener;
+    Instrumentation _instrumentation;
+
+    template <Order::Type Type>
+    bool try_execute(Order &order); // return true if incoming order fully executed
+
+    bool try_execute_any(Order &order)
+    {
+        return order.type() == Order::Type::Bid ? try_execute<Order::Type::Bid>(order)
+                                                : try_execute<Order::Type::Ask>(order);
+    }
+
+    void execute_and_place(Order &order)
+    {
+        auto start = Instrumentation::now();
+        if (not try_execute_any(order)) // place order to book
+        {
+            place(order);
+            _listener.on_add(order);
+        }
+        _instrumentation.on_add(start);
+    }
+
+    void place(const Order &order)
+    {
+        if (!Instrumentation::enabled)
+        {
+            place_order(order);
+            return;
+        }
+        auto capacity = storage_capacity();
+        auto node_index = place_order(order);
+        auto queue_depth = ladder(order.type()).level(_orders.cold(node_index).level).order_count;
+        _instrumentation.on_place(queue_depth, storage_capacity() != capacity);
+    }
+
+    // returns quantity of modified order left in the book
+    Order::QuantityType modify(OrderNode::Index node_index, Order::PriceType price, Order::QuantityType quantity)
+    {
+        const auto order = _orders.order(node_index);
+        if (quantity == 0)
+        {
+            cancel(node_index);
+            return 0;
+        }
+        _instrumentation.on_modify();
+        if (price == order.price() && quantity <= order.quantity())
+        {
+            ladder(order.type()).reduce(_orders, node_index, quantity);
+            _listener.on_modify(_orders.order(node_index));
+            return quantity;
+        }
+        Order modified_order = order;
+        modified_order.amend(price, quantity);
+        remove_order(ladder(order.type()), node_index);
+        _listener.on_modify(modified_order);
+        if (not try_execute_any(modified_order))
+            place(modified_order);
+        return modified_order.quantity();
+    }
+
+    void cancel(OrderNode::Index node_index)
+    {
+        auto start = Instrumentation::now();
+        const auto order = _orders.order(node_index);
+        _listener.on_cancel(order);
+        remove_order(ladder(order.type()), node_index);
+        _instrumentation.on_cancel(start);
+    }
+
+    OrderResult process(const OrderRequest &request);
+};
+
+template <typename Listener, typename Instrumentation>
+OrderResult BasicOrderBook<Listener, Instrumentation>::process(const OrderRequest &request)
+{
+    OrderResult result{OrderResult::Status::Rested, request.id, 0, 0};
+    auto trade_sequence = _trade_sequence;
+    if (request.action == OrderRequest::Action::Add)
+    {
+        if (!_ask_ladder.accepts(request.price))
+        {
+            result.status = OrderResult::Status::Rejected;
+            return result;
+        }
+        auto order = make_order(request.type, request.price, request.quantity);
+        execute_and_place(order);
+        result.id = order.id();
+        result.executed_quantity = request.quantity - order.quantity();
+        result.status = order.quantity() == 0 ? OrderResult::Status::Filled : OrderResult::Status::Rested;
+        result.trade_count = static_cast<uint32_t>(_trade_sequence - trade_sequence);
+        return result;
+    }
+    auto node_index = _id_order_link.find(request.id);
+    if (node_index == nullptr)
+    {
+        result.status = OrderResult::Status::NotFound;
+    }
+    else if (request.action == OrderRequest::Action::Cancel || request.quantity == 0)
+    {
+        cancel(*node_index);
+        result.status = OrderResult::Status::Canceled;
+    }
+    else if (!_ask_ladder.accepts(request.price))
+    {
+        result.status = OrderResult::Status::Rejected;
+    }
+    else
+    {
+        auto quantity = modify(*node_index, request.price, request.quantity);
+        result.executed_quantity = request.quantity - quantity;
+        result.status = quantity == 0 ? OrderResult::Status::Filled : OrderResult::Status::Rested;
+        result.trade_count = static_cast<uint32_t>(_trade_sequence - trade_sequence);
+    }
+    return result;
+}
+
+template <typename Listener, typename Instrumentation>
+template <Order::Type Type>
+bool BasicOrderBook<Listener, Instrumentation>::try_execute(Order &order)
+{
+    auto start = Instrumentation::now();
+    uint32_t levels = 0; // instrumentation counters, unused without it
+    uint32_t fills = 0;
+    uint32_t partial_fills = 0;
+    Order::PriceType level_price = 0;
+    auto &ladder = OrderSide<Type>::opposite == Order::Type::Ask ? _ask_ladder : _bid_ladder;
+    while (order.quantity() > 0 && !ladder.empty())
+    {
+        auto level_index = ladder.best();
+        const auto &level = ladder.level(level_index);
+        if (!OrderSide<Type>::can_execute(level.price, order.price()))
+            break;
+        if (levels == 0 || level.price != level_price)
+        {
+            ++levels;
+            level_price = level.price;
+        }
+        // first order of the best level is executed first
+        auto node_index = level.head;
+        const auto &container_order = _orders[node_index];
+        // determine execution parameters
+        auto execution_quantity = std::min(container_order.quantity, order.quantity());
+        auto execution_price = level.price;
+        // execution, the rest of partially executed order stays in its place
+        auto executed_order = ladder.split(_orders, level_index, node_index, execution_quantity);
+        _listener.on_execute(executed_order); //may be full order or part
+        auto executed_incoming_order = order.split(execution_quantity, execution_price);
+        _listener.on_execute(executed_incoming_order); //may be full order or part
+        TradeEvent trade;
+        trade.sequence = ++_trade_sequence;
+        trade.maker_id = executed_order.id();
+        trade.taker_id = order.id();
+        trade.price = execution_price;
+        trade.quantity = execution_quantity;
+        trade.maker_remaining = container_order.quantity;
+        trade.taker_remaining = order.quantity();
+        trade.aggressor = Type;
+        _listener.on_trade(trade);
+        if (trade.maker_remaining == 0) // remove fully executed order from book
+        {
+            remove_order(ladder, level_index, node_index);
+            ++fills;
+        }
+        else
+        {
+            ++partial_fills;
+        }
+        update_last_transaction(execution_price, execution_quantity);
+    }
+    _instrumentation.on_execute(start, levels, fills, partial_fills);
+    return order.quantity() == 0;
+}
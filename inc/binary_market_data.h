@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "little_endian.hpp"
+#include "order_book_base.h"
+
+/// @brief Binary depth format written by OrderBookBase::depth_binary.
+///
+/// All fields are little-endian. Header is followed by ask levels and then bid levels,
+/// each side from the best price:
+///
+///     offset  size  header field
+///     0       8     sequence
+///     8       4     number of ask levels
+///     12      4     number of bid levels
+///     16      4     last trade price
+///     20      4     last trade quantity
+///     24      1     flags, bit 0 is set if there was a trade
+///     25      7     reserved, zero
+///
+///     offset  size  level field
+///     0       4     price, signed
+///     4       4     total quantity
+///     8       4     number of orders
+namespace binary_market_data
+{
+constexpr size_t header_size = 32;
+constexpr size_t level_size = 12;
+constexpr uint8_t has_last_trade_flag = 1;
+
+struct Header
+{
+    uint64_t sequence;
+    uint32_t ask_count;
+    uint32_t bid_count;
+    Order::PriceType last_price;
+    Order::QuantityType last_quantity;
+    uint8_t flags;
+};
+
+using little_endian::read_u32;
+using little_endian::read_u64;
+using little_endian::write_u32;
+using little_endian::write_u64;
+
+inline void write_header(uint8_t *out, const Header &header)
+{
+    write_u64(out, header.sequence);
+    write_u32(out + 8, header.ask_count);
+    write_u32(out + 12, header.bid_count);
+    write_u32(out + 16, static_cast<uint32_t>(header.last_price));
+    write_u32(out + 20, header.last_quantity);
+    out[24] = header.flags;
+    for (size_t i = 25; i < header_size; ++i)
+        out[i] = 0;
+}
+
+inline Header read_header(const uint8_t *in)
+{
+    return Header{read_u64(in), read_u32(in + 8), read_u32(in + 12), static_cast<Order::PriceType>(read_u32(in + 16)),
+                  read_u32(in + 20), in[24]};
+}
+
+inline void write_level(uint8_t *out, const BookLevel &level)
+{
+    write_u32(out, static_cast<uint32_t>(level.price));
+    write_u32(out + 4, level.quantity);
+    write_u32(out + 8, level.order_count);
+}
+
+/// @brief level with given number, asks are numbered first
+inline BookLevel read_level(const uint8_t *in, size_t index)
+{
+    const auto *level = in + header_size + index * level_size;
+    return BookLevel{static_cast<Order::PriceType>(read_u32(level)), read_u32(level + 4), read_u32(level + 8)};
+}
+} // namespace binary_market_data
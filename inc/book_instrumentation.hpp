@@ -0,0 +1,142 @@
+#pragma once
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+#include "latency_histogram.hpp"
+
+/// @brief Count, percentiles and maximum of recorded values
+struct HistogramStats
+{
+    uint64_t count = 0;
+    uint64_t p50 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+    uint64_t max = 0;
+};
+
+/// @brief Snapshot of counters and histograms collected by BookInstrumentation
+struct BookStats
+{
+    uint64_t adds = 0;              // added orders
+    uint64_t cancels = 0;           // canceled resting orders, including modifies to zero quantity
+    uint64_t modifies = 0;          // modifies of resting orders to nonzero quantity
+    uint64_t fills = 0;             // resting orders executed fully
+    uint64_t partial_fills = 0;     // resting orders executed in part
+    uint64_t aggressive_orders = 0; // incoming orders executed against the book
+    uint64_t storage_growths = 0;   // placed orders which grew order storage or id index
+    HistogramStats levels_swept;    // price levels executed by one aggressive order
+    HistogramStats queue_depth;     // orders of the level, including just placed order
+    HistogramStats add_cycles;      // matching and placing of added order
+    HistogramStats execute_cycles;  // matching of incoming order, whether it executes or not
+    HistogramStats cancel_cycles;   // removal of canceled order
+};
+
+/// @brief Instrumentation of BasicOrderBook which collects nothing. Its calls are inlined into nothing,
+/// so book without instrumentation doesn't pay for it.
+///
+/// Instrumentation passed to BasicOrderBook provides enabled flag and the same methods. Starts of timed
+/// operations are taken by now() and passed to hooks called at their ends.
+struct NoInstrumentation
+{
+    static constexpr bool enabled = false;
+
+    static uint64_t now() { return 0; }
+    void on_add(uint64_t /*start*/) {}
+    void on_execute(uint64_t /*start*/, uint32_t /*levels*/, uint32_t /*fills*/, uint32_t /*partial_fills*/) {}
+    void on_place(uint32_t /*queue_depth*/, bool /*storage_grown*/) {}
+    void on_cancel(uint64_t /*start*/) {}
+    void on_modify() {}
+    BookStats stats() const { return BookStats(); }
+};
+
+/// @brief Instrumentation which counts book operations and records histograms of their cycles,
+/// levels swept by aggressive orders and depth of queues orders join.
+///
+/// Cycles are read by rdtsc on x86, nanoseconds of steady clock are used elsewhere.
+/// Recording doesn't allocate, histograms are allocated when instrumentation is created.
+class BookInstrumentation
+{
+public:
+    static constexpr bool enabled = true;
+
+    static uint64_t now()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    void on_add(uint64_t start)
+    {
+        ++_stats.adds;
+        _add_cycles.record(now() - start);
+    }
+    void on_execute(uint64_t start, uint32_t levels, uint32_t fills, uint32_t partial_fills)
+    {
+        _execute_cycles.record(now() - start);
+        if (levels == 0)
+            return;
+        ++_stats.aggressive_orders;
+        _stats.fills += fills;
+        _stats.partial_fills += partial_fills;
+        _levels_swept.record(levels);
+    }
+    void on_place(uint32_t queue_depth, bool storage_grown)
+    {
+        _queue_depth.record(queue_depth);
+        _stats.storage_growths += storage_grown;
+    }
+    void on_cancel(uint64_t start)
+    {
+        ++_stats.cancels;
+        _cancel_cycles.record(now() - start);
+    }
+    void on_modify() { ++_stats.modifies; }
+
+    BookStats stats() const
+    {
+        auto stats = _stats;
+        stats.levels_swept = summary(_levels_swept);
+        stats.queue_depth = summary(_queue_depth);
+        stats.add_cycles = summary(_add_cycles);
+        stats.execute_cycles = summary(_execute_cycles);
+        stats.cancel_cycles = summary(_cancel_cycles);
+        return stats;
+    }
+
+    const LatencyHistogram &add_cycles() const { return _add_cycles; }
+    const LatencyHistogram &execute_cycles() const { return _execute_cycles; }
+    const LatencyHistogram &cancel_cycles() const { return _cancel_cycles; }
+
+private:
+    static HistogramStats summary(const LatencyHistogram &histogram)
+    {
+        HistogramStats stats;
+        stats.count = histogram.count();
+        stats.p50 = histogram.percentile(50);
+        stats.p99 = histogram.percentile(99);
+        stats.p999 = histogram.percentile(99.9);
+        stats.max = histogram.max();
+        return stats;
+    }
+
+    BookStats _stats; // counters, histograms are summarized by stats()
+    LatencyHistogram _levels_swept;
+    LatencyHistogram _queue_depth;
+    LatencyHistogram _add_cycles;
+    LatencyHistogram _execute_cycles;
+    LatencyHistogram _cancel_cycles;
+};
+
+/// @brief Instrumentation of OrderBook, selected by ORDER_BOOK_INSTRUMENTATION build option
+#ifdef ORDER_BOOK_INSTRUMENTATION
+using OrderBookInstrumentation = BookInstrumentation;
+#else
+using OrderBookInstrumentation = NoInstrumentation;
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+
+#include "trade_event.hpp"
+
+/// @brief Listener which ignores all book events. Listeners passed to BasicOrderBook
+/// may derive from it and hide only hooks they need.
+struct NullListener
+{
+    /// @brief rest of incoming order is placed to the book
+    void on_add(const Order &) {}
+    /// @brief part of resting or incoming order is executed, called for both orders of each match
+    void on_execute(const Order &) {}
+    /// @brief resting order is canceled
+    void on_cancel(const Order &) {}
+    /// @brief resting order got new price or quantity, called before its execution if new price allows it
+    void on_modify(const Order &) {}
+    /// @brief resting and incoming orders are matched, called once per match after on_execute
+    void on_trade(const TradeEvent &) {}
+};
+
+/// @brief Listener which writes trade events into buffer provided by caller.
+///
+/// Buffer is filled from the beginning after each reset(). Events which don't fit are counted by dropped().
+class TradeEventWriter : public NullListener
+{
+public:
+    TradeEventWriter(TradeEvent *buffer, size_t capacity) : _buffer(buffer), _capacity(capacity) {}
+
+    void on_trade(const TradeEvent &event)
+    {
+        if (_size < _capacity)
+            _buffer[_size++] = event;
+        else
+            ++_dropped;
+    }
+
+    const TradeEvent *events() const { return _buffer; }
+    size_t size() const { return _size; }
+    size_t dropped() const { return _dropped; }
+    void reset()
+    {
+        _size = 0;
+        _dropped = 0;
+    }
+
+private:
+    TradeEvent *_buffer;
+    size_t _capacity;
+    size_t _size = 0;
+    size_t _dropped = 0;
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/// @brief Binary snapshot of the book written by OrderBookBase::save_snapshot.
+///
+/// All fields are little-endian. Header is followed by ask orders and then bid orders, each side
+/// in priority order: the best price first, orders of the same price in queue order.
+///
+/// Next id is written for books taking ids from IdSource too: ids below it and ids of loaded orders are never
+/// given again by the restored book.
+///
+///     offset  size  header field
+///     0       4     magic "OBS1"
+///     4       4     order record size
+///     8       8     number of ask orders
+///     16      8     number of bid orders
+///     24      4     last trade price
+///     28      4     last trade quantity
+///     32      4     flags, bit 0 is set if there was a trade, bit 1 if the book counts its ids itself
+///     36      4     reserved, zero
+///     40      8     sequence number of the last trade
+///     48      8     next id of the book, 0 if the book hasn't taken ids from its source
+///     56      8     end of ids of the book, meaningful if the book counts its ids itself
+///
+///     offset  size  order field
+///     0       8     id
+///     8       4     price, signed
+///     12      4     quantity
+namespace book_snapshot
+{
+constexpr size_t header_size = 64;
+constexpr size_t record_size = 16;
+constexpr uint32_t has_last_trade_flag = 1;
+constexpr uint32_t own_ids_flag = 2;
+} // namespace book_snapshot
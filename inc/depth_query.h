@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "depth_snapshot.hpp"
+
+/// @brief Result of walking one side of the book from the best price to fill requested quantity
+struct FillEstimate
+{
+    uint64_t quantity = 0;            // quantity available for the fill, at most requested one
+    int64_t notional = 0;             // sum of price * quantity of the fill
+    Order::PriceType worst_price = 0; // price of the last level the fill takes, 0 if side is empty
+    uint32_t levels = 0;              // number of levels the fill takes
+    bool complete = false;            // side has enough quantity
+
+    double vwap() const { return quantity == 0 ? 0.0 : static_cast<double>(notional) / static_cast<double>(quantity); }
+};
+
+/// @brief Depth of both sides copied from the book into arrays answering cumulative queries.
+///
+/// update() copies up to max_levels levels of each side with cumulative quantity and notional, so each
+/// query is a search over sorted arrays instead of a walk over the ladder. Levels near the best price
+/// are scanned with AVX2 or SSE4.2 if the processor has them, deeper levels by binary search.
+/// Queries made between updates don't touch the book and can be repeated for each routing decision.
+///
+/// DepthQuery isn't synchronized, update and queries are called by one thread. Thread which can't touch
+/// the book, e.g. router beside OrderPipeline, keeps its own DepthQuery updated from DepthSnapshot data.
+class DepthQuery
+{
+public:
+    /// @brief Instruction set used by queries
+    enum class SimdLevel
+    {
+        Scalar,
+        Sse42,
+        Avx2
+    };
+
+    /// @param max_levels number of levels of each side kept for queries
+    /// @param simd_level instruction set used by queries, the best supported one below it is taken
+    explicit DepthQuery(size_t max_levels = 1024, SimdLevel simd_level = SimdLevel::Avx2);
+
+    /// @brief copy levels of both sides, doesn't allocate
+    void update(const OrderBookBase &book);
+    /// @brief copy levels of snapshot read from DepthSnapshot, doesn't allocate
+    template <size_t Depth>
+    void update(const DepthSnapshotData<Depth> &data)
+    {
+        update_side(Span<const BookLevel>(data.asks, data.ask_count), _asks);
+        update_side(Span<const BookLevel>(data.bids, data.bid_count), _bids);
+    }
+
+    /// @brief number of copied levels of the side
+    size_t level_count(Order::Type type) const { return side(type).size; }
+
+    /// @brief Total quantity of levels whose price differs from the best price of the side by at most distance.
+    ///
+    /// Distance is in price units, with tick size 1 it is number of ticks. Negative distance gives 0.
+    uint64_t quantity_within(Order::Type type, Order::PriceType distance) const;
+
+    /// @brief Walk levels of the side from the best price until quantity is filled.
+    ///
+    /// Incoming bid is filled from Ask side and vice versa. If copied levels don't have the quantity,
+    /// estimate covers all of them and complete is false.
+    FillEstimate fill(Order::Type type, uint64_t quantity) const;
+
+    /// @brief Instruction set used by queries
+    SimdLevel simd_level() const { return _simd_level; }
+    /// @brief The best instruction set of the processor, detected once
+    static SimdLevel supported_simd_level();
+
+private:
+    // levels of one side from the best price, arrays are padded to block of simd_block values by maximal values
+    struct Side
+    {
+        std::vector<Order::PriceType> prices;
+        std::vector<int32_t> distances; // from the best price
+        std::vector<int64_t> quantities; // cumulative
+        std::vector<int64_t> notionals;  // cumulative
+        size_t size = 0;
+    };
+
+    static constexpr size_t simd_block = 8;
+    using FindAbove32 = size_t (*)(const int32_t *values, size_t size, int32_t limit);
+    using FindAbove64 = size_t (*)(const int64_t *values, size_t size, int64_t limit);
+
+    void update_side(const PriceLadder &ladder, Side &side);
+    void update_side(Span<const BookLevel> levels, Side &side);
+    void append_level(Side &side, Order::PriceType price, Order::QuantityType quantity); // after the last one
+    void finish_side(Side &side);
+    const Side &side(Order::Type type) const { return type == Order::Type::Ask ? _asks : _bids; }
+
+    size_t _max_levels;
+    SimdLevel _simd_level;
+    FindAbove32 _find_above_32; // kernels of _simd_level
+    FindAbove64 _find_above_64;
+    Side _asks;
+    Side _bids;
+};
@@ -0,0 +1,117 @@
+#pragma once
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+#include "order_book_base.h"
+
+/// @brief Receiver of book state after each batch of events processed by matching thread
+class BookObserver
+{
+public:
+    virtual ~BookObserver() = default;
+    virtual void on_batch(const OrderBookBase &book) = 0;
+};
+
+/// @brief Top Depth levels of both sides and the last trade
+template <size_t Depth>
+struct DepthSnapshotData
+{
+    uint64_t version; // number of publish, 0 means nothing is published yet
+    uint32_t ask_count;
+    uint32_t bid_count;
+    BookLevel asks[Depth]; // the best price first
+    BookLevel bids[Depth];
+    uint32_t has_last_trade;
+    BookLevel last_trade;
+};
+
+/// @brief Top of the book published by matching thread and read by any number of other threads.
+///
+/// Snapshot is sequence lock over two slots: writer fills the slot readers don't point to and then
+/// switches them to it, so writer never waits for readers and readers never block writer. Reader
+/// repeats the copy only if writer rewrote its slot during the copy, which takes two publishes.
+/// Data is copied by relaxed atomic words, so readers never see torn values.
+template <size_t Depth>
+class DepthSnapshot : public BookObserver
+{
+public:
+    using Data = DepthSnapshotData<Depth>;
+
+    DepthSnapshot()
+    {
+        Data data;
+        std::memset(&data, 0, sizeof(data));
+        for (auto &slot : _slots)
+            store(slot, data);
+    }
+
+    /// @brief Publish top of the book, called by one writer thread
+    void publish(const OrderBookBase &book)
+    {
+        Data data;
+        std::memset(&data, 0, sizeof(data)); // padding is copied too
+        data.version = ++_version;
+        data.ask_count = static_cast<uint32_t>(book.depth(Order::Type::Ask, Span<BookLevel>(data.asks, Depth)));
+        data.bid_count = static_cast<uint32_t>(book.depth(Order::Type::Bid, Span<BookLevel>(data.bids, Depth)));
+        auto last_trade = book.last_trade();
+        data.has_last_trade = last_trade.first;
+        data.last_trade = last_trade.second;
+
+        auto slot_index = 1 - _latest.load(std::memory_order_relaxed);
+        auto &slot = _slots[slot_index];
+        auto sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed); // odd while slot is written
+        std::atomic_thread_fence(std::memory_order_release);
+        store(slot, data);
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+        _latest.store(slot_index, std::memory_order_release);
+    }
+
+    void on_batch(const OrderBookBase &book) override { publish(book); }
+
+    /// @brief Copy the last published snapshot, called by reader threads
+    void read(Data &data) const
+    {
+        for (;;)
+        {
+            const auto &slot = _slots[_latest.load(std::memory_order_acquire)];
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence & 1)
+                continue; // writer has lapped the reader and fills this slot again
+            load(slot, data);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+                return;
+        }
+    }
+
+private:
+    static_assert(std::is_trivially_copyable<Data>::value, "snapshot is copied as words");
+    static constexpr size_t word_count = (sizeof(Data) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint64_t> words[word_count];
+    };
+
+    static void store(Slot &slot, const Data &data)
+    {
+        uint64_t words[word_count] = {};
+        std::memcpy(words, &data, sizeof(data));
+        for (size_t i = 0; i < word_count; ++i)
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    static void load(const Slot &slot, Data &data)
+    {
+        uint64_t words[word_count];
+        for (size_t i = 0; i < word_count; ++i)
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        std::memcpy(&data, words, sizeof(data));
+    }
+
+    Slot _slots[2];
+    std::atomic<unsigned> _latest{0};
+    uint64_t _version = 0; // used only by writer
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+#include "memory_resource.hpp"
+
+/// @brief Bitset with summary layers: bit of upper layer is set if corresponding word
+/// of lower layer is not zero. Search of next set bit takes one word scan per layer.
+class HierarchicalBitset
+{
+public:
+    static constexpr size_t npos = SIZE_MAX;
+
+    explicit HierarchicalBitset(size_t size, MemoryResource *resource = nullptr)
+        : _words(BookAllocator<uint64_t>(resource))
+    {
+        size_t words = 0;
+        do
+        {
+            assert(_layer_count < max_layers);
+            size = size == 0 ? 1 : (size + word_bits - 1) / word_bits;
+            _offsets[_layer_count++] = words;
+            words += size;
+        } while (size > 1);
+        _words.resize(words, 0);
+    }
+
+    bool empty() const { return _words.back() == 0; }
+
+    void set(size_t pos)
+    {
+        for (size_t l = 0; l < _layer_count; ++l)
+        {
+            auto &word = layer(l)[pos / word_bits];
+            auto was_empty = word == 0;
+            word |= bit(pos);
+            if (!was_empty)
+                break; // upper layers are already marked
+            pos /= word_bits;
+        }
+    }
+
+    void reset(size_t pos)
+    {
+        for (size_t l = 0; l < _layer_count; ++l)
+        {
+            auto &word = layer(l)[pos / word_bits];
+            word &= ~bit(pos);
+            if (word != 0)
+                break; // upper layers still have to be marked
+            pos /= word_bits;
+        }
+    }
+
+    size_t find_first() const
+    {
+        if (empty())
+            return npos;
+        return descend_first(_layer_count, 0);
+    }
+
+    size_t find_last() const
+    {
+        if (empty())
+            return npos;
+        return descend_last(_layer_count, 0);
+    }
+
+    /// @brief first set bit after pos
+    size_t find_next(size_t pos) const
+    {
+        for (size_t l = 0; l < _layer_count; ++l)
+        {
+            auto index = pos % word_bits;
+            auto word = index == word_bits - 1 ? 0 : layer(l)[pos / word_bits] & (~uint64_t(0) << (index + 1));
+            if (word != 0)
+                return descend_first(l, pos / word_bits * word_bits + __builtin_ctzll(word));
+            pos /= word_bits;
+        }
+        return npos;
+    }
+
+    /// @brief last set bit before pos
+    size_t find_prev(size_t pos) const
+    {
+        for (size_t l = 0; l < _layer_count; ++l)
+        {
+            auto index = pos % word_bits;
+            auto word = layer(l)[pos / word_bits] & (bit(index) - 1);
+            if (word != 0)
+                return descend_last(l, pos / word_bits * word_bits + last_bit(word));
+            pos /= word_bits;
+        }
+        return npos;
+    }
+
+private:
+    static constexpr size_t word_bits = 64;
+    static constexpr size_t max_layers = 6; // up to 64^6 bits
+
+    static uint64_t bit(size_t pos) { return uint64_t(1) << (pos % word_bits); }
+    static size_t last_bit(uint64_t word) { return word_bits - 1 - __builtin_clzll(word); }
+
+    uint64_t *layer(size_t l) { return _words.data() + _offsets[l]; }
+    const uint64_t *layer(size_t l) const { return _words.data() + _offsets[l]; }
+
+    // pos is set bit of the layer (the only word of virtual layer above the top one),
+    // go down to the first set bit of layer 0 under it
+    size_t descend_first(size_t l, size_t pos) const
+    {
+        while (l-- != 0)
+            pos = pos * word_bits + __builtin_ctzll(layer(l)[pos]);
+        return pos;
+    }
+    size_t descend_last(size_t l, size_t pos) const
+    {
+        while (l-- != 0)
+            pos = pos * word_bits + last_bit(layer(l)[pos]);
+        return pos;
+    }
+
+    std::vector<uint64_t, BookAllocator<uint64_t>> _words; // all layers, the top one is the last word
+    std::array<size_t, max_layers> _offsets{};             // first word of each layer
+    size_t _layer_count = 0;
+};
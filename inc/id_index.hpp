@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "memory_resource.hpp"
+#include "order.hpp"
+#include "price_ladder.h"
+
+/// @brief Map of order id to resting order node.
+///
+/// Open addressing table with linear probing. Order ids are generated by counter, so they are spread
+/// over the table by multiplicative (Fibonacci) hash: with identity hash live ids form one long run of
+/// occupied slots, which each erase and each id wrapped around the table size has to walk.
+/// Erase shifts following entries back instead of leaving tombstones, so cancel-heavy flow
+/// doesn't degrade lookups and the table never needs cleanup rehash.
+class IdIndex
+{
+public:
+    using Value = OrderNode::Index;
+
+    explicit IdIndex(MemoryResource *resource = nullptr, size_t capacity = 0)
+        : _slots(slot_count(capacity), Slot(), BookAllocator<Slot>(resource)) {}
+
+    size_t size() const { return _size; }
+    size_t capacity() const { return _slots.size() / 2; } // ids which fit without rehash
+
+    /// @brief make room for capacity ids, so that insert doesn't rehash
+    void reserve(size_t capacity)
+    {
+        if (slot_count(capacity) > _slots.size())
+            rehash(slot_count(capacity));
+    }
+
+    /// @brief returns false if id is already present
+    bool insert(Order::IdType id, Value value)
+    {
+        assert(id != empty_id);
+        if ((_size + 1) * 2 > _slots.size())
+            rehash(_slots.size() * 2);
+        for (auto pos = home(id);; pos = next(pos))
+        {
+            auto &slot = _slots[pos];
+            if (slot.id == id)
+                return false;
+            if (slot.id == empty_id)
+            {
+                slot.id = id;
+                slot.value = value;
+                ++_size;
+                return true;
+            }
+        }
+    }
+
+    /// @brief returns nullptr if id is not found
+    const Value *find(Order::IdType id) const
+    {
+        for (auto pos = home(id);; pos = next(pos))
+        {
+            const auto &slot = _slots[pos];
+            if (slot.id == id)
+                return &slot.value;
+            if (slot.id == empty_id)
+                return nullptr;
+        }
+    }
+
+    /// @brief returns false if id is not found
+    bool erase(Order::IdType id)
+    {
+        auto pos = home(id);
+        for (; _slots[pos].id != id; pos = next(pos))
+        {
+            if (_slots[pos].id == empty_id)
+                return false;
+        }
+        // move back entries which can't be found after the hole appears
+        for (auto cur = next(pos); _slots[cur].id != empty_id; cur = next(cur))
+        {
+            auto cur_home = home(_slots[cur].id);
+            if (((cur - cur_home) & mask()) >= ((cur - pos) & mask()))
+            {
+                _slots[pos] = _slots[cur];
+                pos = cur;
+            }
+        }
+        _slots[pos].id = empty_id;
+        --_size;
+        return true;
+    }
+
+private:
+    static constexpr Order::IdType empty_id = 0; // ids are counted from 1
+    static constexpr size_t min_capacity = 64;
+
+    struct Slot
+    {
+        Order::IdType id = empty_id;
+        Value value = 0;
+    };
+
+    static size_t slot_count(size_t capacity) // keeps table at most half full
+    {
+        size_t count = min_capacity;
+        while (count < capacity * 2)
+            count *= 2;
+        return count;
+    }
+    size_t mask() const { return _slots.size() - 1; }
+    size_t home(Order::IdType id) const
+    {
+        return static_cast<size_t>((id * UINT64_C(0x9e3779b97f4a7c15)) >> 32) & mask();
+    }
+    size_t next(size_t pos) const { return (pos + 1) & mask(); }
+
+    void rehash(size_t capacity)
+    {
+        std::vector<Slot, BookAllocator<Slot>> slots(capacity, Slot(), _slots.get_allocator());
+        slots.swap(_slots);
+        _size = 0;
+        for (const auto &slot : slots)
+        {
+            if (slot.id != empty_id)
+                insert(slot.id, slot.value);
+        }
+    }
+
+    std::vector<Slot, BookAllocator<Slot>> _slots; // size is power of 2
+    size_t _size = 0;
+};
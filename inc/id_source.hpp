@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "order.hpp"
+
+/// @brief Ids from first to end, not including end
+struct IdBlock
+{
+    Order::IdType first;
+    Order::IdType end;
+};
+
+/// @brief Source of order ids for books.
+///
+/// Book takes ids from source in blocks and counts them itself, so source is called once per block.
+/// Blocks given to the same book have to be increasing, so that ids of the book stay monotonic.
+/// Ids are prefix in high bits and counter in low counter_bits bits. Prefix 0 is used by shared() source.
+class IdSource
+{
+public:
+    static constexpr int counter_bits = 40;
+
+    virtual ~IdSource() = default;
+
+    /// @brief Next block of ids. Can be called from any thread.
+    virtual IdBlock allocate_block() = 0;
+
+    /// @brief Never give ids up to last_id, e.g. ids of orders restored from snapshot. Can be called from any
+    /// thread. Returns false if source can't skip ids.
+    virtual bool reserve_through(Order::IdType /*last_id*/) { return false; }
+
+    /// @brief Process-wide source used by books by default
+    static IdSource *shared();
+
+    /// @brief Prefix not taken by other books or threads of the process, starts from 1.
+    static uint32_t allocate_prefix();
+
+    /// @brief Make allocate_prefix never return prefixes up to prefix, e.g. prefix of restored book
+    static void reserve_prefix(uint32_t prefix);
+
+    /// @brief All ids with given prefix
+    static IdBlock prefix_block(uint32_t prefix)
+    {
+        return IdBlock{(static_cast<Order::IdType>(prefix) << counter_bits) + 1,
+                       static_cast<Order::IdType>(prefix + uint64_t(1)) << counter_bits};
+    }
+};
+
+/// @brief Hands out blocks of ids with prefix 0 from one shared counter.
+///
+/// Counter is touched once per block_size ids, so books on different threads rarely contend for it.
+/// The first id has to be greater than 0, which is never used as order id. Ids of other prefixes belong
+/// to books and threads which took them by allocate_prefix, so the source throws OrderBookBase::Exception
+/// when its prefix is exhausted instead of going on to them.
+class BlockIdSource : public IdSource
+{
+public:
+    explicit BlockIdSource(size_t block_size = 4096, Order::IdType first = 1) : _next(first), _block_size(block_size) {}
+
+    IdBlock allocate_block() override;
+    /// @brief Returns false if last_id is beyond prefix 0
+    bool reserve_through(Order::IdType last_id) override;
+
+private:
+    std::atomic<Order::IdType> _next;
+    size_t _block_size;
+};
+
+/// @brief Each thread counts ids with its own prefix taken on the first call from the thread.
+///
+/// Nothing is shared between threads after that. Book using this source has to stay on one thread,
+/// e.g. worker of OrderBookManager shard, otherwise its ids are not monotonic.
+class ThreadIdSource : public IdSource
+{
+public:
+    explicit ThreadIdSource(size_t block_size = 4096) : _block_size(block_size) {}
+
+    IdBlock allocate_block() override;
+
+private:
+    size_t _block_size;
+};
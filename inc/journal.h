@@ -0,0 +1,148 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "basic_order_book.hpp"
+
+/// @brief Binary journal of book requests for recovery after restart.
+///
+/// File starts with header followed by one record per request, all fields are little-endian:
+///
+///     offset  size  header field
+///     0       4     magic "OBJ1"
+///     4       4     record size
+///     8       8     first id of the book when journal was started
+///     16      8     end of ids of the book
+///     24      8     reserved, zero
+///
+///     offset  size  record field
+///     0       8     sequence number, starts from 1
+///     8       8     order id of cancel and modify
+///     16      4     price, signed
+///     20      4     quantity
+///     24      1     action, OrderRequest::Action
+///     25      1     order type of add, Order::Type
+///     26      6     reserved, zero
+///
+/// Requests are journaled before the book processes them. Book has to count its ids itself
+/// (set_id_prefix or set_id_block), so replay into the book with the same state and ids gives
+/// the same order ids and queue priority.
+namespace journal
+{
+constexpr size_t header_size = 32;
+constexpr size_t record_size = 32;
+} // namespace journal
+
+/// @brief Appends requests to journal file through buffer.
+///
+/// Buffer is written to the file when it is full, file is synced to disk after each fsync_group
+/// records, so one fsync covers the whole group. Records not synced yet can be lost on crash.
+class JournalWriter
+{
+public:
+    /// @brief Create new journal, existing file is replaced. Throws OrderBookBase::Exception
+    /// if file can't be created or book doesn't count its ids itself.
+    ///
+    /// @param path journal file
+    /// @param book book which requests are journaled, its ids are saved to header
+    /// @param fsync_group number of records synced at once, 0 means sync only by sync() and destructor
+    /// @param buffer_size size of write buffer in bytes
+    JournalWriter(const std::string &path, const OrderBookBase &book, size_t fsync_group = 1024,
+                  size_t buffer_size = 64 * 1024);
+    JournalWriter(const JournalWriter &) = delete;
+    JournalWriter &operator=(const JournalWriter &) = delete;
+    ~JournalWriter();
+
+    /// @brief Append request, called before the book processes it
+    void append(const OrderRequest &request);
+    void append(Span<const OrderRequest> requests)
+    {
+        for (const auto &request : requests)
+            append(request);
+    }
+
+    /// @brief Write buffered records to the file
+    void flush();
+    /// @brief Write buffered records and wait until the file is on disk
+    void sync();
+
+    /// @brief Sequence number of the last appended record
+    uint64_t sequence() const { return _sequence; }
+
+private:
+    std::string _path; // named by errors
+    int _file;
+    std::vector<uint8_t> _buffer;
+    size_t _buffer_used = 0;
+    size_t _fsync_group;
+    size_t _unsynced = 0; // records appended after the last sync
+    uint64_t _sequence = 0;
+};
+
+/// @brief Reads requests from journal file in large blocks
+class JournalReader
+{
+public:
+    /// @brief Open journal, throws OrderBookBase::Exception if file can't be read or has wrong header
+    explicit JournalReader(const std::string &path, size_t buffer_size = 1024 * 1024);
+    JournalReader(const JournalReader &) = delete;
+    JournalReader &operator=(const JournalReader &) = delete;
+    ~JournalReader();
+
+    /// @brief Ids of the book when journal was started
+    const IdBlock &ids() const { return _ids; }
+
+    /// @brief Read next requests, returns number of read requests, 0 at the end of journal.
+    ///
+    /// Incomplete record at the end of file, left by crash during write, is ignored.
+    /// Throws OrderBookBase::Exception if sequence numbers are broken.
+    size_t read(Span<OrderRequest> requests);
+
+    /// @brief Sequence number of the last read record
+    uint64_t sequence() const { return _sequence; }
+
+private:
+    bool fill_buffer();
+
+    std::string _path; // named by errors
+    int _file;
+    std::vector<uint8_t> _buffer;
+    size_t _buffer_begin = 0; // position of the first unread byte
+    size_t _buffer_end = 0;
+    bool _end_of_file = false;
+    IdBlock _ids;
+    uint64_t _sequence = 0;
+};
+
+/// @brief Apply requests of journal to the book, returns number of applied requests.
+///
+/// Book has to be in the state it had when journal was started, e.g. empty or loaded from snapshot.
+/// It continues to count ids after the last journaled order.
+template <typename Listener, typename Instrumentation>
+uint64_t replay_journal(const std::string &path, BasicOrderBook<Listener, Instrumentation> &book)
+{
+    JournalReader reader(path);
+    book.set_id_block(reader.ids());
+    const size_t batch_size = 1024;
+    std::vector<OrderRequest> requests(batch_size);
+    std::vector<OrderResult> results(batch_size);
+    uint64_t count = 0;
+    for (;;)
+    {
+        auto read_count = reader.read(requests);
+        if (read_count == 0)
+            return count;
+        book.add_orders(Span<const OrderRequest>(requests.data(), read_count), results);
+        count += read_count;
+    }
+}
+
+/// @brief Journal requests and process them by the book, the same as BasicOrderBook::add_orders
+template <typename Listener, typename Instrumentation>
+size_t add_orders_journaled(BasicOrderBook<Listener, Instrumentation> &book, JournalWriter &journal,
+                            Span<const OrderRequest> requests, Span<OrderResult> results)
+{
+    auto count = std::min(requests.size(), results.size());
+    journal.append(requests.subspan(0, count));
+    return book.add_orders(requests.subspan(0, count), results);
+}
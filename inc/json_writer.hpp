@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// @brief Output format of JSON market data
+enum class JsonFormat
+{
+    Pretty, // indented, one value per line
+    Compact // without whitespace
+};
+
+/// @brief Appends JSON text to caller's string, whitespace is skipped in compact format.
+///
+/// Numbers are converted by two digits at a time with digit pair table. Written string
+/// keeps its capacity between calls, so reused buffer stops allocating once it is large enough.
+class JsonWriter
+{
+public:
+    JsonWriter(std::string &out, JsonFormat format) : _out(out), _pretty(format == JsonFormat::Pretty) {}
+
+    bool pretty() const { return _pretty; }
+
+    template <size_t N>
+    void text(const char (&str)[N])
+    {
+        _out.append(str, N - 1);
+    }
+
+    /// @brief object key with following colon
+    template <size_t N>
+    void key(const char (&name)[N])
+    {
+        _out += '"';
+        _out.append(name, N - 1);
+        if (_pretty)
+            _out.append("\": ", 3);
+        else
+            _out.append("\":", 2);
+    }
+
+    void newline()
+    {
+        if (_pretty)
+            _out += '\n';
+    }
+
+    void indent(size_t spaces)
+    {
+        if (_pretty)
+            _out.append(spaces, ' ');
+    }
+
+    void number(uint64_t value)
+    {
+        char buffer[20];
+        auto *end = buffer + sizeof(buffer);
+        auto *begin = format_digits(value, end);
+        _out.append(begin, end);
+    }
+
+    void number(int64_t value)
+    {
+        if (value < 0)
+        {
+            _out += '-';
+            number(0 - static_cast<uint64_t>(value));
+        }
+        else
+        {
+            number(static_cast<uint64_t>(value));
+        }
+    }
+
+    void number(uint32_t value) { number(static_cast<uint64_t>(value)); }
+    void number(int32_t value) { number(static_cast<int64_t>(value)); }
+
+private:
+    // writes digits backwards ending at end, returns position of the first digit
+    static char *format_digits(uint64_t value, char *end)
+    {
+        static const char digit_pairs[] = "00010203040506070809"
+                                          "10111213141516171819"
+                                          "20212223242526272829"
+                                          "30313233343536373839"
+                                          "40414243444546474849"
+                                          "50515253545556575859"
+                                          "60616263646566676869"
+                                          "70717273747576777879"
+                                          "80818283848586878889"
+                                          "90919293949596979899";
+        auto *pos = end;
+        while (value >= 100)
+        {
+            auto pair = static_cast<size_t>(value % 100) * 2;
+            value /= 100;
+            *--pos = digit_pairs[pair + 1];
+            *--pos = digit_pairs[pair];
+        }
+        if (value >= 10)
+        {
+            auto pair = static_cast<size_t>(value) * 2;
+            *--pos = digit_pairs[pair + 1];
+            *--pos = digit_pairs[pair];
+        }
+        else
+        {
+            *--pos = static_cast<char>('0' + value);
+        }
+        return pos;
+    }
+
+    std::string &_out;
+    bool _pretty;
+};
@@ -0,0 +1,75 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/// @brief Histogram of latencies with bounded relative error, in the manner of HdrHistogram.
+///
+/// Values below 128 are counted exactly. Larger values are counted in buckets of 64 sub-buckets per power
+/// of two, so reported percentiles are within 1/64 of recorded values. Recording is a few arithmetic
+/// instructions without allocation.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram() : _counts(bucket_count, 0) {}
+
+    void record(uint64_t value)
+    {
+        ++_counts[index(value)];
+        ++_count;
+        _max = std::max(_max, value);
+    }
+
+    uint64_t count() const { return _count; }
+    uint64_t max() const { return _max; }
+
+    /// @brief the least value not less than percent of recorded values, up to bucket precision
+    uint64_t percentile(double percent) const
+    {
+        if (_count == 0)
+            return 0;
+        auto rank = static_cast<uint64_t>(percent / 100.0 * static_cast<double>(_count) + 0.5);
+        rank = std::max<uint64_t>(1, std::min(rank, _count));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < _counts.size(); ++i)
+        {
+            seen += _counts[i];
+            if (seen >= rank)
+                return std::min(highest_value(i), _max);
+        }
+        return _max;
+    }
+
+    void reset()
+    {
+        std::fill(_counts.begin(), _counts.end(), 0);
+        _count = 0;
+        _max = 0;
+    }
+
+private:
+    static constexpr int sub_bucket_bits = 7; // values below 2^7 are exact
+    static constexpr uint64_t half_sub_buckets = uint64_t(1) << (sub_bucket_bits - 1);
+    static constexpr size_t bucket_count = (64 - sub_bucket_bits + 2) * half_sub_buckets;
+
+    static int magnitude(uint64_t value) // number of bits above sub_bucket_bits
+    {
+        auto rest = value >> sub_bucket_bits;
+        return rest == 0 ? 0 : 64 - __builtin_clzll(rest);
+    }
+    static size_t index(uint64_t value)
+    {
+        auto shift = magnitude(value);
+        return static_cast<size_t>(shift * half_sub_buckets + (value >> shift));
+    }
+    static uint64_t highest_value(size_t index)
+    {
+        auto shift = index < 2 * half_sub_buckets ? 0 : static_cast<int>(index / half_sub_buckets - 1);
+        auto sub_bucket = index - shift * half_sub_buckets;
+        return ((sub_bucket + 1) << shift) - 1;
+    }
+
+    std::vector<uint64_t> _counts;
+    uint64_t _count = 0;
+    uint64_t _max = 0;
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+
+/// @brief Fixed-width little-endian fields of binary formats, independent of host byte order
+namespace little_endian
+{
+inline void write_u32(uint8_t *out, uint32_t value)
+{
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+    out[2] = static_cast<uint8_t>(value >> 16);
+    out[3] = static_cast<uint8_t>(value >> 24);
+}
+
+inline void write_u64(uint8_t *out, uint64_t value)
+{
+    write_u32(out, static_cast<uint32_t>(value));
+    write_u32(out + 4, static_cast<uint32_t>(value >> 32));
+}
+
+inline uint32_t read_u32(const uint8_t *in)
+{
+    return static_cast<uint32_t>(in[0]) | static_cast<uint32_t>(in[1]) << 8 | static_cast<uint32_t>(in[2]) << 16 |
+           static_cast<uint32_t>(in[3]) << 24;
+}
+
+inline uint64_t read_u64(const uint8_t *in)
+{
+    return static_cast<uint64_t>(read_u32(in)) | static_cast<uint64_t>(read_u32(in + 4)) << 32;
+}
+} // namespace little_endian
@@ -0,0 +1,67 @@
+#pragma once
+#include <utility>
+#include <vector>
+
+#include "order_book_base.h"
+
+/// @brief Change of one price level of the book
+struct LevelUpdate
+{
+    enum class Action
+    {
+        New,    // level appeared
+        Change, // total quantity of level changed
+        Delete  // level disappeared, quantity is 0
+    };
+    Action action;
+    Order::Type side;
+    Order::PriceType price;
+    Order::QuantityType quantity; // total quantity of orders with this price
+};
+
+/// @brief Header of published updates
+struct MarketDataHeader
+{
+    uint64_t sequence;  // number of the publish with changes, starts from 1, 0 means nothing published yet
+    bool trade_updated; // there were trades since previous publish
+    bool has_last_trade;
+    Order::PriceType last_price;
+    Order::QuantityType last_quantity;
+};
+
+/// @brief Publishes price levels changed since previous publish instead of the whole book.
+///
+/// Book tracks prices of changed levels, so publish costs O(changed levels). Consumer starts from
+/// snapshot() and applies updates of publishes with greater sequence; missed sequence means
+/// consumer has to take snapshot again. Only one publisher can be attached to a book, because
+/// publish clears changes tracked by the book.
+class MarketDataPublisher
+{
+public:
+    explicit MarketDataPublisher(OrderBookBase &book);
+
+    /// @brief Append updates of levels changed since previous publish.
+    ///
+    /// Sequence is increased if there are level updates or trades.
+    MarketDataHeader publish(std::vector<LevelUpdate> &updates);
+
+    /// @brief Append all levels known to consumers as of sequence() as New updates, asks then bids,
+    /// best price first.
+    MarketDataHeader snapshot(std::vector<LevelUpdate> &levels) const;
+
+    uint64_t sequence() const { return _sequence; }
+
+private:
+    using PublishedLevels = std::vector<std::pair<Order::PriceType, Order::QuantityType>>; // sorted by price
+
+    void publish_changes(PriceLadder &ladder, PublishedLevels &published, std::vector<LevelUpdate> &updates);
+    void publish_all(PriceLadder &ladder, PublishedLevels &published, std::vector<LevelUpdate> &updates);
+    MarketDataHeader header(bool trade_updated) const;
+
+    OrderBookBase &_book;
+    PublishedLevels _published_asks;
+    PublishedLevels _published_bids;
+    uint64_t _sequence = 0;
+    uint64_t _trade_sequence = 0; // trade sequence of the book at previous publish
+    bool _synchronized = false;   // changes tracked by the book are relative to published levels
+};
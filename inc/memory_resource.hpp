@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+
+/// @brief Source of memory for book storage, the same idea as std::pmr::memory_resource
+class MemoryResource
+{
+public:
+    virtual ~MemoryResource() = default;
+    virtual void *allocate(size_t bytes, size_t alignment) = 0;
+    virtual void deallocate(void *ptr, size_t bytes, size_t alignment) = 0;
+
+    /// @brief resource based on global operator new and delete
+    static MemoryResource *new_delete();
+
+private:
+    class NewDeleteResource;
+};
+
+class MemoryResource::NewDeleteResource : public MemoryResource
+{
+public:
+    void *allocate(size_t bytes, size_t /*alignment*/) override { return ::operator new(bytes); }
+    void deallocate(void *ptr, size_t /*bytes*/, size_t /*alignment*/) override { ::operator delete(ptr); }
+};
+
+inline MemoryResource *MemoryResource::new_delete()
+{
+    static NewDeleteResource resource;
+    return &resource;
+}
+
+/// @brief Monotonic arena carved from one buffer allocated at construction.
+///
+/// Deallocation doesn't return memory to the arena, so it suits storage which is reserved once,
+/// like books created with enough BookMemory capacity. When arena is exhausted, memory is taken
+/// from upstream resource.
+class ArenaResource : public MemoryResource
+{
+public:
+    explicit ArenaResource(size_t bytes, MemoryResource *upstream = MemoryResource::new_delete())
+        : _upstream(upstream), _buffer(new char[bytes]), _buffer_end(_buffer.get() + bytes),
+          _free_ptr(_buffer.get()), _free_bytes(bytes) {}
+
+    void *allocate(size_t bytes, size_t alignment) override
+    {
+        void *ptr = _free_ptr;
+        if (std::align(alignment, bytes, ptr, _free_bytes))
+        {
+            _free_ptr = static_cast<char *>(ptr) + bytes;
+            _free_bytes -= bytes;
+            return ptr;
+        }
+        return _upstream->allocate(bytes, alignment);
+    }
+    void deallocate(void *ptr, size_t bytes, size_t alignment) override
+    {
+        std::less<const char *> less;
+        auto char_ptr = static_cast<const char *>(ptr);
+        if (less(char_ptr, _buffer.get()) || !less(char_ptr, _buffer_end))
+            _upstream->deallocate(ptr, bytes, alignment);
+    }
+
+private:
+    MemoryResource *_upstream;
+    std::unique_ptr<char[]> _buffer;
+    const char *_buffer_end;
+    void *_free_ptr;
+    size_t _free_bytes;
+};
+
+/// @brief STL allocator which takes memory from MemoryResource
+template <typename T>
+class BookAllocator
+{
+public:
+    using value_type = T;
+
+    BookAllocator(MemoryResource *resource = nullptr)
+        : _resource(resource ? resource : MemoryResource::new_delete()) {}
+    template <typename U>
+    BookAllocator(const BookAllocator<U> &other) : _resource(other.resource()) {}
+
+    T *allocate(size_t n) { return static_cast<T *>(_resource->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T *ptr, size_t n) { _resource->deallocate(ptr, n * sizeof(T), alignof(T)); }
+    MemoryResource *resource() const { return _resource; }
+
+    template <typename U>
+    bool operator==(const BookAllocator<U> &other) const { return _resource == other.resource(); }
+    template <typename U>
+    bool operator!=(const BookAllocator<U> &other) const { return _resource != other.resource(); }
+
+private:
+    MemoryResource *_resource;
+};
+
+/// @brief Memory settings of the book. Storage for given number of orders and levels is allocated
+/// at construction, so the book doesn't allocate while it stays within these limits.
+struct BookMemory
+{
+    size_t orders = 1024;  // resting orders
+    size_t levels = 128;   // price levels of each side, not used by book with PriceBand
+    MemoryResource *resource = nullptr; // storage source, global new and delete if nullptr
+};
@@ -6,7 +6,7 @@
 class Order
 {
 public:
-    enum class Type
+    enum class Type : uint8_t
     {
         Ask,
         Bid
@@ -15,8 +15,9 @@ public:
     using PriceType = int32_t;
     using QuantityType = uint32_t;
 
-    Order(Type type, PriceType price, QuantityType quantity)
-        : _type(type), _price(price), _quantity(quantity), _id(++next_id) {}
+    // id is assigned by the book
+    Order(Type type, PriceType price, QuantityType quantity, IdType id)
+        : _type(type), _price(price), _quantity(quantity), _id(id) {}
 
     // return order with the same id, price, type but split original _quantity
     // by new quantity and rest which saved in current order
@@ -30,6 +31,12 @@ public:
         _quantity -= quantity;
         return new_order;
     }
+    // change price and quantity of the order keeping its id
+    void amend(PriceType price, QuantityType quantity)
+    {
+        _price = price;
+        _quantity = quantity;
+    }
     Type type() const { return _type; }
     PriceType price() const { return _price; }
     QuantityType quantity() const { return _quantity; }
@@ -40,7 +47,6 @@ public:
     }
 private:
     Order(): _price(0), _quantity(0), _id(0)  {}
-    static IdType next_id; // id generator for new order
     IdType _id;
     PriceType _price;
     QuantityType _quantity;
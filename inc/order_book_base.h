@@ -0,0 +1,412 @@
+#pragma once
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "id_index.hpp"
+#include "id_source.hpp"
+#include "json_writer.hpp"
+#include "order.hpp"
+#include "price_ladder.h"
+#include "span.hpp"
+
+/// @brief Aggregated orders of one price
+struct BookLevel
+{
+    Order::PriceType price;
+    Order::QuantityType quantity; // total quantity of orders with this price
+    uint32_t order_count;
+};
+
+/// @brief Resting order of bulk load, its id is assigned by the book
+struct RestingOrder
+{
+    Order::PriceType price;
+    Order::QuantityType quantity;
+};
+
+/// @brief Storage and market data of the order book. Matching and notifications are
+/// implemented by BasicOrderBook.
+class OrderBookBase
+{
+public:
+    struct Exception : public std::runtime_error
+    {
+        Exception(const std::string &message) throw()
+            : std::runtime_error(message) {}
+    };
+    struct NotFoundException : public Exception
+    {
+        NotFoundException(const std::string &message) throw()
+            : Exception(message) {}
+    };
+    struct OutOfBandException : public Exception
+    {
+        OutOfBandException(const std::string &message) throw()
+            : Exception(message) {}
+    };
+
+    /// @brief Get order copy. Can be used to print order info. Can throw NotFoundException
+    ///
+    /// @param id order id
+    Order get_order(Order::IdType id) const;
+
+    /// @brief The highest bid level, first is false if there are no bids.
+    ///
+    /// Level totals are kept up to date by the book, so the query doesn't depend on number of orders.
+    std::pair<bool, BookLevel> best_bid() const { return best_level(_bid_ladder); }
+
+    /// @brief The lowest ask level, first is false if there are no asks.
+    std::pair<bool, BookLevel> best_ask() const { return best_level(_ask_ladder); }
+
+    /// @brief Price and quantity of the last transaction, first is false if there were no trades.
+    ///
+    /// Quantity is summed over consecutive trades at the same price, as in market_data_1_json.
+    std::pair<bool, BookLevel> last_trade() const
+    {
+        return std::make_pair(_transactions_started, BookLevel{_last_price, _last_quantity, 0});
+    }
+
+    /// @brief Number of price levels of the side
+    size_t level_count(Order::Type type) const
+    {
+        return type == Order::Type::Ask ? _ask_ladder.level_count() : _bid_ladder.level_count();
+    }
+
+    /// @brief Copy the best levels of the side, the best price first.
+    ///
+    /// @param type side of the book
+    /// @param levels buffer for levels
+    /// @return number of copied levels, the least of levels size and level_count(type)
+    size_t depth(Order::Type type, Span<BookLevel> levels) const;
+
+    /// @brief Encode levels of the book in binary format described in binary_market_data.h.
+    ///
+    /// Nothing is allocated, levels are written directly into the buffer.
+    ///
+    /// @param sequence sequence number written to the header, e.g. MarketDataPublisher::sequence()
+    /// @param buffer destination of encoded data
+    /// @param bid_order_limit max number of bid levels, -1 means all levels
+    /// @param ask_order_limit max number of ask levels, -1 means all levels
+    /// @return number of written bytes, 0 if buffer is smaller than depth_binary_size
+    size_t depth_binary(uint64_t sequence, Span<uint8_t> buffer, int bid_order_limit = -1,
+                        int ask_order_limit = -1) const;
+
+    /// @brief Size of buffer required by depth_binary with the same limits
+    size_t depth_binary_size(int bid_order_limit = -1, int ask_order_limit = -1) const;
+
+    /// @brief Number of low bits of order id counted with id prefix
+    static constexpr int id_counter_bits = IdSource::counter_bits;
+
+    /// @brief Count ids of the book with given prefix instead of taking them from id source.
+    ///
+    /// Ids of new orders are prefix in high bits and counter of the book in low id_counter_bits bits.
+    /// Books with different prefixes never produce the same id, IdSource::allocate_prefix gives
+    /// prefix not used by other books. Should be called before the first order is added. Throws
+    /// Exception if prefix doesn't fit into the high bits.
+    void set_id_prefix(uint32_t prefix);
+
+    /// @brief Take ids of new orders from source, nullptr means IdSource::shared() used by default.
+    ///
+    /// Source has to outlive the book. Should be called before the first order is added.
+    void set_id_source(IdSource *source);
+
+    /// @brief Count ids of the book from ids.first to ids.end itself, e.g. to continue ids after recovery.
+    void set_id_block(const IdBlock &ids)
+    {
+        _id_source = nullptr;
+        _next_id = ids.first;
+        _end_id = ids.end;
+    }
+
+    /// @brief Ids the book will give to new orders if it counts ids itself, see id_source()
+    IdBlock id_block() const { return IdBlock{_next_id, _end_id}; }
+
+    /// @brief Source of ids of the book, nullptr if the book counts ids itself
+    IdSource *id_source() const { return _id_source; }
+
+    /// @brief Build empty book from resting orders without matching and notifications.
+    ///
+    /// Orders of each side are given in priority order: the best price first, orders of the same price in
+    /// queue order. Orders are placed in linear time and consistency is checked once at the end.
+    /// Throws Exception if the book isn't empty, orders aren't sorted, have zero quantity, asks and bids cross,
+    /// or own ids of the book are not enough; OutOfBandException if price is out of band. The book is left
+    /// unchanged in these cases.
+    ///
+    /// @param asks ask orders, the lowest price first
+    /// @param bids bid orders, the highest price first
+    /// @param ids if not empty, receives ids of loaded orders, asks first. Has to have room for all orders.
+    void load_orders(Span<const RestingOrder> asks, Span<const RestingOrder> bids,
+                     Span<Order::IdType> ids = Span<Order::IdType>());
+
+    /// @brief Save resting orders in priority order, the last trade and ids of the book to file in format
+    /// described in book_snapshot.h. Throws Exception if file can't be written.
+    void save_snapshot(const std::string &path) const;
+
+    /// @brief Restore empty book from file written by save_snapshot.
+    ///
+    /// File is mapped to memory and orders are placed in bulk without matching and notifications.
+    /// If the saved book counted its ids itself, the book continues them, otherwise it keeps its id source.
+    /// Throws Exception if the book isn't empty, file can't be read or is broken, or prices are out of band.
+    /// Orders and ids are checked before anything is changed, so after failed load the book is still empty
+    /// and keeps its ids, and its id source hasn't skipped any ids.
+    void load_snapshot(const std::string &path);
+
+    /// @brief orderbook information in JSON format
+    ///
+    /// @param bid_order_limit max number bid positions, -1 means output all bid positions
+    /// @param ask_order_limit max number ask positions, -1 means output all ask positions
+    std::string orderbook_info_json(int bid_order_limit = -1, int ask_order_limit = -1) const;
+
+    /// @brief orderbook information in JSON format written to reused string
+    ///
+    /// @param out destination string, its content is replaced
+    /// @param bid_order_limit max number bid positions, -1 means output all bid positions
+    /// @param ask_order_limit max number ask positions, -1 means output all ask positions
+    /// @param format pretty format is the same as returned by orderbook_info_json()
+    void orderbook_info_json(std::string &out, int bid_order_limit = -1, int ask_order_limit = -1,
+                             JsonFormat format = JsonFormat::Pretty) const;
+
+    /// @brief market data 1 in JSON format
+    std::string market_data_1_json() const;
+
+    /// @brief market data 1 in JSON format written to reused string, content of out is replaced
+    void market_data_1_json(std::string &out, JsonFormat format = JsonFormat::Pretty) const;
+
+    /// @brief market data 2 in JSON format
+    std::string market_data_2_json(int bid_order_limit = -1, int ask_order_limit = -1) const;
+
+    /// @brief market data 2 in JSON format written to reused string, content of out is replaced
+    void market_data_2_json(std::string &out, int bid_order_limit = -1, int ask_order_limit = -1,
+                            JsonFormat format = JsonFormat::Pretty) const;
+
+protected:
+    explicit OrderBookBase(const BookMemory &memory)
+        : _orders(memory.resource, memory.orders), _ask_ladder(Order::Type::Ask, memory),
+          _bid_ladder(Order::Type::Bid, memory), _id_order_link(memory.resource, memory.orders) {}
+    OrderBookBase(const PriceBand &band, const BookMemory &memory)
+        : _orders(memory.resource, memory.orders), _ask_ladder(Order::Type::Ask, checked_band(band), memory),
+          _bid_ladder(Order::Type::Bid, band, memory), _id_order_link(memory.resource, memory.orders) {}
+
+    using OrderPool = PriceLadder::OrderPool;
+
+    OrderPool _orders;
+    PriceLadder _ask_ladder;
+    PriceLadder _bid_ladder;
+    IdIndex _id_order_link;
+
+    bool _transactions_started = false;
+    Order::PriceType _last_price = 0;
+    Order::QuantityType _last_quantity = 0;
+    uint64_t _trade_sequence = 0; // sequence number of the last TradeEvent
+    IdSource *_id_source = IdSource::shared(); // nullptr if book counts ids itself
+    Order::IdType _next_id = 0;                // ids from _next_id to _end_id are not used yet
+    Order::IdType _end_id = 0;
+
+    Order make_order(Order::Type type, Order::PriceType price, Order::QuantityType quantity)
+    {
+        if (_next_id == _end_id)
+            allocate_ids();
+        return Order(type, price, quantity, _next_id++);
+    }
+    void allocate_ids();
+
+    /// @brief Check orders to be placed by bulk_load, sides provide size(), price(i) and quantity(i) of orders
+    /// in priority order, the best price first. Throws the same exceptions as load_orders.
+    template <typename AskSide, typename BidSide>
+    void check_bulk_load(const AskSide &asks, const BidSide &bids) const;
+
+    /// @brief Place orders checked by check_bulk_load to empty book without matching.
+    ///
+    /// order(i) of sides is called once for each order. Ids of orders have to be nonzero and unique, ids not
+    /// assigned by the book are checked by check_bulk_ids first.
+    template <typename AskSide, typename BidSide>
+    void bulk_load(const AskSide &asks, const BidSide &bids);
+
+    /// @brief Check ids of orders to be loaded by bulk_load, sides provide id(i). Throws Exception for zero or
+    /// duplicate id. Returns the greatest id, 0 if there are no orders.
+    template <typename AskSide, typename BidSide>
+    static Order::IdType check_bulk_ids(const AskSide &asks, const BidSide &bids);
+
+    template <typename Side>
+    void check_bulk_side(const PriceLadder &ladder, const Side &side) const;
+    template <typename Side>
+    void bulk_load_side(PriceLadder &ladder, const Side &side);
+
+    OrderNode::Index find_order(Order::IdType id) const
+    {
+        auto node_index = _id_order_link.find(id);
+        if (node_index == nullptr)
+        {
+            throw OrderBookBase::NotFoundException(std::string("Order id ") + std::to_string(id) + "not found");
+        }
+        return *node_index;
+    }
+    void check_price(Order::PriceType price) const
+    {
+        if (!_ask_ladder.accepts(price))
+        {
+            throw OrderBookBase::OutOfBandException(std::string("Price ") + std::to_string(price) + " is out of book price band");
+        }
+    }
+    PriceLadder &ladder(Order::Type type)
+    {
+        return type == Order::Type::Ask ? _ask_ladder : _bid_ladder;
+    }
+    /// @brief place rest of not executed order to the book
+    OrderNode::Index place_order(const Order &order)
+    {
+        auto node_index = _orders.emplace(order);
+        ladder(order.type()).push_back(_orders, node_index);
+        auto inserted = _id_order_link.insert(order.id(), node_index);
+        assert(inserted);
+        (void)inserted;
+        return node_index;
+    }
+    /// @brief number of orders storage and id index hold without reallocation
+    size_t storage_capacity() const { return _orders.capacity() + _id_order_link.capacity(); }
+    /// @brief remove executed or canceled order from the book
+    void remove_order(PriceLadder &ladder, OrderNode::Index node_index)
+    {
+        _id_order_link.erase(_orders[node_index].id);
+        ladder.unlink(_orders, node_index);
+        _orders.release(node_index);
+    }
+    /// @brief remove order of known level, executed orders are removed without reading their cold records
+    void remove_order(PriceLadder &ladder, PriceLadder::LevelIndex level_index, OrderNode::Index node_index)
+    {
+        _id_order_link.erase(_orders[node_index].id);
+        ladder.unlink(_orders, node_index, level_index);
+        _orders.release(node_index);
+    }
+    void update_last_transaction(Order::PriceType execution_price, Order::QuantityType execution_quantity)
+    {
+        if (_transactions_started && _last_price == execution_price)
+            _last_quantity += execution_quantity;
+        else
+            _last_quantity = execution_quantity;
+        _last_price = execution_price;
+        _transactions_started = true;
+    }
+    bool check_consistency() const
+    {
+        return _orders.size() == _id_order_link.size();
+    }
+
+private:
+    friend class MarketDataPublisher;
+    friend class DepthQuery;
+
+    static std::pair<bool, BookLevel> best_level(const PriceLadder &ladder)
+    {
+        if (ladder.empty())
+            return std::make_pair(false, BookLevel{0, 0, 0});
+        const auto &level = ladder.level(ladder.best());
+        return std::make_pair(true, BookLevel{level.price, level.quantity, level.order_count});
+    }
+
+    static const PriceBand &checked_band(const PriceBand &band)
+    {
+        if (band.tick_size <= 0 || band.min_price > band.max_price)
+            throw OrderBookBase::Exception("Invalid price band");
+        if (band.size() > PriceBand::max_slots)
+            throw OrderBookBase::Exception("Price band has " + std::to_string(band.size()) + " ticks, at most " +
+                                           std::to_string(PriceBand::max_slots) + " are allowed");
+        return band;
+    }
+
+    /// @brief Walks levels of one side from the best price, common to JSON and binary output
+    class PriceAggregator
+    {
+    public:
+        explicit PriceAggregator(const PriceLadder &ladder)
+            : _ladder(ladder), _cursor(ladder.first()){};
+        std::pair<bool, BookLevel> next_price();
+    private:
+        const PriceLadder &_ladder;
+        PriceLadder::Cursor _cursor;
+    };
+
+    PriceAggregator make_price_aggregator(Order::Type type) const;
+
+    friend void out_orders_json(JsonWriter &writer, int order_limit, OrderBookBase::PriceAggregator &aggregator);
+    void orderbook_info_json_internal(JsonWriter &writer, int bid_order_limit, int ask_order_limit) const;
+    // returns false if nothing is written
+    bool market_data_1_json_internal(JsonWriter &writer) const;
+};
+
+template <typename AskSide, typename BidSide>
+void OrderBookBase::check_bulk_load(const AskSide &asks, const BidSide &bids) const
+{
+    if (_orders.size() != 0)
+        throw OrderBookBase::Exception("Orders can be loaded only to empty book");
+    check_bulk_side(_ask_ladder, asks);
+    check_bulk_side(_bid_ladder, bids);
+    if (asks.size() != 0 && bids.size() != 0 && asks.price(0) <= bids.price(0))
+        throw OrderBookBase::Exception("Loaded asks and bids cross");
+}
+
+template <typename AskSide, typename BidSide>
+void OrderBookBase::bulk_load(const AskSide &asks, const BidSide &bids)
+{
+    assert(_orders.size() == 0);
+    _orders.reserve(asks.size() + bids.size());
+    _id_order_link.reserve(asks.size() + bids.size());
+    bulk_load_side(_ask_ladder, asks);
+    bulk_load_side(_bid_ladder, bids);
+    assert(check_consistency());
+}
+
+template <typename AskSide, typename BidSide>
+Order::IdType OrderBookBase::check_bulk_ids(const AskSide &asks, const BidSide &bids)
+{
+    IdIndex ids(nullptr, asks.size() + bids.size());
+    Order::IdType max_id = 0;
+    auto check_side = [&ids, &max_id](const auto &side) {
+        for (size_t i = 0; i < side.size(); ++i)
+        {
+            auto id = side.id(i);
+            if (id == 0)
+                throw OrderBookBase::Exception("Loaded order has zero id");
+            if (!ids.insert(id, 0))
+                throw OrderBookBase::Exception(std::string("Loaded order id ") + std::to_string(id) +
+                                               " is duplicated");
+            max_id = std::max(max_id, id);
+        }
+    };
+    check_side(asks);
+    check_side(bids);
+    return max_id;
+}
+
+template <typename Side>
+void OrderBookBase::check_bulk_side(const PriceLadder &ladder, const Side &side) const
+{
+    for (size_t i = 0; i < side.size(); ++i)
+    {
+        auto price = side.price(i);
+        if (!ladder.accepts(price))
+            throw OrderBookBase::OutOfBandException(std::string("Price ") + std::to_string(price) +
+                                                    " is out of book price band");
+        if (side.quantity(i) == 0)
+            throw OrderBookBase::Exception("Loaded order has zero quantity");
+        if (i > 0 && (ladder.side() == Order::Type::Ask ? price < side.price(i - 1) : price > side.price(i - 1)))
+            throw OrderBookBase::Exception("Loaded orders aren't sorted by price");
+    }
+}
+
+template <typename Side>
+void OrderBookBase::bulk_load_side(PriceLadder &ladder, const Side &side)
+{
+    for (size_t i = 0; i < side.size(); ++i)
+    {
+        auto node_index = _orders.emplace(side.order(i));
+        assert(_orders[node_index].id != 0);
+        ladder.load_back(_orders, node_index);
+        auto inserted = _id_order_link.insert(_orders[node_index].id, node_index);
+        assert(inserted);
+        (void)inserted;
+    }
+    ladder.finish_load();
+}
@@ -0,0 +1,237 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "basic_order_book.hpp"
+#include "ring_buffer.hpp"
+#include "thread_affinity.h"
+
+/// @brief Order books of many instruments processed by worker threads.
+///
+/// Books are distributed between shards in order of registration, each shard is processed by its own
+/// worker thread pinned to a core. Book is touched only by the worker of its shard, so books need no
+/// locks. Requests are queued to lock-free MpscRing of the shard, worker drains it in batches and passes
+/// requests of each book in the batch to one add_orders call. Requests of one instrument are processed in
+/// order of submission. Workers poll their queues instead of sleeping, so each of them keeps its core busy
+/// while running.
+///
+/// Each book gets its own id prefix, so ids are unique across books without shared counter.
+template <typename Listener = NullListener>
+class OrderBookManager
+{
+public:
+    using InstrumentId = uint32_t;
+    using Book = BasicOrderBook<Listener>;
+    /// @brief receiver of request results, called on worker thread of instrument shard
+    using ResultHandler = std::function<void(InstrumentId, const OrderResult &)>;
+
+    /// @brief Creates OrderBookManager, workers are started by start().
+    ///
+    /// @param worker_count number of shards and worker threads, at least 1
+    /// @param result_handler receiver of request results. May be nullptr.
+    /// @param pin_threads bind worker of shard N to core N
+    /// @param queue_capacity size of request queue of each shard, rounded up to power of 2
+    explicit OrderBookManager(size_t worker_count, ResultHandler result_handler = nullptr, bool pin_threads = true,
+                              size_t queue_capacity = 65536)
+        : _result_handler(std::move(result_handler)), _pin_threads(pin_threads)
+    {
+        for (size_t i = 0; i < std::max<size_t>(worker_count, 1); ++i)
+            _shards.emplace_back(new Shard(queue_capacity));
+    }
+    OrderBookManager(const OrderBookManager &) = delete;
+    OrderBookManager &operator=(const OrderBookManager &) = delete;
+    ~OrderBookManager() { stop(); }
+
+    /// @brief Register book of instrument. Throws Exception if instrument is already registered
+    /// or workers are running.
+    Book &add_book(InstrumentId instrument, Listener listener = Listener(), const BookMemory &memory = BookMemory())
+    {
+        check_new_instrument(instrument);
+        return register_book(instrument, std::unique_ptr<Book>(new Book(std::move(listener), memory)));
+    }
+
+    /// @brief Register book of instrument with dense price levels for bounded price range.
+    Book &add_book(InstrumentId instrument, const PriceBand &band, Listener listener = Listener(),
+                   const BookMemory &memory = BookMemory())
+    {
+        check_new_instrument(instrument);
+        return register_book(instrument, std::unique_ptr<Book>(new Book(band, std::move(listener), memory)));
+    }
+
+    /// @brief Book of instrument, nullptr if instrument is unknown.
+    ///
+    /// Book can be accessed directly only while workers are stopped.
+    Book *book(InstrumentId instrument)
+    {
+        auto route = _routes.find(instrument);
+        return route == _routes.end() ? nullptr : route->second.book;
+    }
+
+    size_t book_count() const { return _routes.size(); }
+    size_t worker_count() const { return _shards.size(); }
+    bool running() const { return _running; }
+
+    /// @brief Start worker threads
+    void start()
+    {
+        if (_running)
+            return;
+        _running = true;
+        for (size_t i = 0; i < _shards.size(); ++i)
+        {
+            auto &shard = *_shards[i];
+            shard.stopping.store(false, std::memory_order_relaxed);
+            shard.thread = std::thread([this, &shard] { run(shard); });
+            if (_pin_threads)
+                pin_thread_to_core(shard.thread, i);
+        }
+    }
+
+    /// @brief Process already submitted requests and stop worker threads
+    void stop()
+    {
+        if (!_running)
+            return;
+        for (auto &shard : _shards)
+            shard->stopping.store(true, std::memory_order_release);
+        for (auto &shard : _shards)
+            shard->thread.join();
+        _running = false;
+    }
+
+    /// @brief Queue request to the book of instrument, can be called by any thread. Returns false if
+    /// instrument is unknown, or if workers are stopped and queue of the shard is full.
+    ///
+    /// While workers are running full queue is waited for. Requests submitted while workers are
+    /// stopped are processed after start().
+    bool submit(InstrumentId instrument, const OrderRequest &request)
+    {
+        auto route = _routes.find(instrument);
+        if (route == _routes.end())
+            return false;
+        auto &shard = *_shards[route->second.shard];
+        Task task{route->second.book, instrument, request};
+        while (!shard.queue.try_push(task))
+        {
+            if (!_running)
+                return false;
+            std::this_thread::yield();
+        }
+        shard.submitted.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Wait until all submitted requests are processed, workers have to be running
+    void wait_idle()
+    {
+        for (auto &shard : _shards)
+        {
+            while (shard->processed.load(std::memory_order_acquire) != shard->submitted.load(std::memory_order_acquire))
+                std::this_thread::yield();
+        }
+    }
+
+private:
+    struct Task
+    {
+        Book *book;
+        InstrumentId instrument;
+        OrderRequest request;
+    };
+
+    struct Shard
+    {
+        explicit Shard(size_t queue_capacity) : queue(queue_capacity) {}
+
+        MpscRing<Task> queue;
+        std::atomic<uint64_t> submitted{0}; // changed by producers after push
+        std::atomic<uint64_t> processed{0}; // changed by worker
+        std::atomic<bool> stopping{false};
+        std::thread thread;
+    };
+
+    struct Route
+    {
+        Book *book;
+        size_t shard;
+    };
+
+    void check_new_instrument(InstrumentId instrument) const
+    {
+        if (_running)
+            throw OrderBookBase::Exception("Books can't be added while workers are running");
+        if (_routes.count(instrument) != 0)
+            throw OrderBookBase::Exception(std::string("Instrument ") + std::to_string(instrument) +
+                                           " is already registered");
+    }
+
+    Book &register_book(InstrumentId instrument, std::unique_ptr<Book> book)
+    {
+        book->set_id_prefix(IdSource::allocate_prefix());
+        _routes[instrument] = Route{book.get(), _books.size() % _shards.size()};
+        _books.push_back(std::move(book));
+        return *_books.back();
+    }
+
+    static constexpr size_t max_batch = 256;
+
+    // Requests of the batch are grouped by book through preallocated array of positions sorted by book
+    // and position, so each book gets one add_orders call, requests of one instrument keep their order
+    // and worker doesn't allocate (std::stable_sort would take temporary buffer for each batch).
+    void run(Shard &shard)
+    {
+        std::vector<Task> batch(max_batch);
+        std::vector<uint16_t> order(max_batch); // positions in batch grouped by book
+        std::vector<OrderRequest> requests;
+        std::vector<OrderResult> results;
+        requests.reserve(max_batch);
+        results.reserve(max_batch);
+        auto processed = shard.processed.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto count = shard.queue.pop(batch.data(), batch.size());
+            if (count == 0)
+            {
+                // requests submitted before stop are processed first
+                if (shard.stopping.load(std::memory_order_acquire) &&
+                    shard.submitted.load(std::memory_order_acquire) == processed)
+                    return;
+                std::this_thread::yield();
+                continue;
+            }
+            for (size_t i = 0; i < count; ++i)
+                order[i] = static_cast<uint16_t>(i);
+            std::sort(order.begin(), order.begin() + count, [&batch](uint16_t a, uint16_t b) {
+                return batch[a].book != batch[b].book ? std::less<Book *>()(batch[a].book, batch[b].book) : a < b;
+            });
+            for (size_t begin = 0, end = 0; begin < count; begin = end)
+            {
+                auto *book = batch[order[begin]].book;
+                requests.clear();
+                for (end = begin; end < count && batch[order[end]].book == book; ++end)
+                    requests.push_back(batch[order[end]].request);
+                results.resize(requests.size());
+                book->add_orders(requests, results);
+                if (_result_handler)
+                {
+                    for (size_t i = 0; i < results.size(); ++i)
+                        _result_handler(batch[order[begin + i]].instrument, results[i]);
+                }
+            }
+            processed += count;
+            shard.processed.store(processed, std::memory_order_release);
+        }
+    }
+
+    ResultHandler _result_handler;
+    bool _pin_threads;
+    std::atomic<bool> _running{false};
+    std::vector<std::unique_ptr<Shard>> _shards;
+    std::vector<std::unique_ptr<Book>> _books;
+    std::unordered_map<InstrumentId, Route> _routes; // isn't changed while workers are running
+};
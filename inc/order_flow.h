@@ -0,0 +1,97 @@
+#pragma once
+#include <limits>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "basic_order_book.hpp"
+
+/// @brief Request of order flow with its arrival time
+struct FlowEvent
+{
+    uint64_t time; // nanoseconds from the start of the flow
+    OrderRequest request;
+};
+
+/// @brief Parameters of synthetic order flow
+struct FlowConfig
+{
+    uint64_t seed = 1;
+    double arrival_rate = 1e6; // mean number of requests per second, arrivals are Poisson
+    Order::PriceType mid_price = 10000;
+    Order::PriceType mid_drift_limit = 50; // best prices used as reference stay within mid_price +- limit
+    double offset_exponent = 2.5;          // offset from the touch in ticks is power-law distributed, P(x) ~ x^-exponent
+    Order::PriceType max_offset = 100;     // offsets above are clipped
+    double cancel_ratio = 0.45;            // share of cancels among requests when book is full
+    size_t resting_orders = 10000;         // size of full book, smaller book gets proportionally fewer cancels
+    double modify_ratio = 0.05;            // share of modifies among requests
+    double aggressive_ratio = 0.1;         // share of adds priced at the best price of other side
+    double sweep_probability = 0.002;      // share of adds which sweep several levels of other side
+    Order::PriceType sweep_levels = 10;    // sweep price is this many ticks beyond the best price of other side
+    Order::QuantityType min_quantity = 1;
+    Order::QuantityType max_quantity = 100;
+    Order::IdType first_id = 1; // id the book assigns to the first added order
+};
+
+/// @brief Deterministic generator of synthetic order flow.
+///
+/// Generator applies the flow to its own book, so cancels and modifies refer to orders resting in the book
+/// which assigns consecutive ids from first_id to added orders (set_id_block(ids()) on empty book).
+/// Passive orders are placed at power-law distributed offsets from the best price of other side, so they
+/// join or improve the touch most often. The same config gives the same flow with the same standard library.
+class OrderFlowGenerator
+{
+public:
+    explicit OrderFlowGenerator(const FlowConfig &config = FlowConfig());
+
+    FlowEvent next();
+    void generate(Span<FlowEvent> events)
+    {
+        for (auto &event : events)
+            event = next();
+    }
+
+    /// @brief ids the book has to assign to added orders
+    IdBlock ids() const { return IdBlock{_config.first_id, std::numeric_limits<Order::IdType>::max()}; }
+
+private:
+    // collects resting orders executed by the flow
+    struct FillListener : NullListener
+    {
+        void on_trade(const TradeEvent &trade)
+        {
+            if (trade.maker_remaining == 0)
+                filled_ids.push_back(trade.maker_id);
+        }
+        std::vector<Order::IdType> filled_ids;
+    };
+
+    OrderRequest add_request();
+    Order::PriceType reference_price(Order::Type type) const; // best price of the side or its substitute
+    Order::PriceType offset();
+    Order::QuantityType quantity();
+    void track(const OrderRequest &request, const OrderResult &result);
+    void remove_live(Order::IdType id);
+
+    FlowConfig _config;
+    std::mt19937_64 _random;
+    std::exponential_distribution<double> _interval;
+    std::uniform_real_distribution<double> _uniform{0.0, 1.0};
+    double _time = 0;
+    BasicOrderBook<FillListener> _book;
+    std::vector<Order::IdType> _live_ids;                      // resting orders of the book
+    std::unordered_map<Order::IdType, size_t> _live_positions; // position of id in _live_ids
+};
+
+/// @brief Read recorded flow from text file. Throws OrderBookBase::Exception if file can't be read or has
+/// invalid line.
+///
+/// Each line is one request, fields are separated by commas, empty lines and lines starting with # are skipped:
+///
+///     time,A,B|S,price,quantity    add bid or ask (sell)
+///     time,C,id                    cancel
+///     time,M,id,price,quantity     modify
+///
+/// Time is in nanoseconds from the start of the flow.
+std::vector<FlowEvent> read_flow_csv(const std::string &path);
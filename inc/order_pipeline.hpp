@@ -0,0 +1,145 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "basic_order_book.hpp"
+#include "depth_snapshot.hpp"
+#include "ring_buffer.hpp"
+#include "thread_affinity.h"
+
+/// @brief Request sent by gateway thread to matching thread
+struct OrderCommand
+{
+    OrderRequest request;
+    uint64_t tag;         // caller's value returned with result, e.g. client order id
+    uint64_t submit_time; // steady clock nanoseconds when command was pushed
+};
+
+/// @brief Result sent by matching thread to publisher thread
+struct PipelineResult
+{
+    OrderResult result;
+    uint64_t tag;
+    uint64_t submit_time;  // command was pushed to ingress ring
+    uint64_t dequeue_time; // batch with the command was taken by matching thread
+    uint64_t done_time;    // batch with the command was processed by the book
+};
+
+/// @brief Book processed by dedicated matching thread.
+///
+/// Gateway threads push commands into Ingress ring, MpscRing by default, SpscRing is enough for
+/// one gateway. Matching thread drains it in batches, processes them by the book and pushes results
+/// to outbound SpscRing read by one publisher thread. If outbound ring is full matching thread waits
+/// for publisher. Timestamps of results separate queueing latency (dequeue_time - submit_time)
+/// from matching latency (done_time - dequeue_time). Optional BookObserver, e.g. DepthSnapshot,
+/// gets the book after each batch on matching thread.
+template <typename Listener = NullListener, typename Ingress = MpscRing<OrderCommand>>
+class OrderPipeline
+{
+public:
+    using Book = BasicOrderBook<Listener>;
+
+    /// @brief Creates OrderPipeline, matching thread is started by start().
+    ///
+    /// @param book book processed by matching thread, must not be used by other threads while it runs
+    /// @param ingress_capacity size of ingress ring, rounded up to power of 2
+    /// @param outbound_capacity size of outbound ring, rounded up to power of 2
+    /// @param batch_size max number of commands taken from ingress ring at once
+    OrderPipeline(Book &book, size_t ingress_capacity = 4096, size_t outbound_capacity = 4096,
+                  size_t batch_size = 64)
+        : _book(book), _ingress(ingress_capacity), _outbound(outbound_capacity),
+          _batch_size(std::max<size_t>(batch_size, 1)) {}
+    OrderPipeline(const OrderPipeline &) = delete;
+    OrderPipeline &operator=(const OrderPipeline &) = delete;
+    ~OrderPipeline() { stop(); }
+
+    static uint64_t now()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    /// @brief Set receiver of book state after each batch, nullptr means none. Called before start().
+    void set_observer(BookObserver *observer) { _observer = observer; }
+
+    /// @brief Start matching thread
+    ///
+    /// @param core core to pin matching thread to, negative value means no pinning
+    void start(int core = -1)
+    {
+        if (_thread.joinable())
+            return;
+        _stopping.store(false, std::memory_order_relaxed);
+        _thread = std::thread([this] { run(); });
+        if (core >= 0)
+            pin_thread_to_core(_thread, static_cast<size_t>(core));
+    }
+
+    /// @brief Process commands already pushed to ingress ring and stop matching thread.
+    ///
+    /// Publisher has to keep polling results until stop returns if outbound ring may get full.
+    void stop()
+    {
+        if (!_thread.joinable())
+            return;
+        _stopping.store(true, std::memory_order_release);
+        _thread.join();
+    }
+
+    /// @brief Push command to ingress ring, returns false if ring is full. Called by gateway threads.
+    bool submit(const OrderRequest &request, uint64_t tag = 0)
+    {
+        return _ingress.try_push(OrderCommand{request, tag, now()});
+    }
+
+    /// @brief Take up to results.size() results, returns number of taken results. Called by publisher thread.
+    size_t poll(Span<PipelineResult> results) { return _outbound.pop(results.data(), results.size()); }
+
+private:
+    void run()
+    {
+        std::vector<OrderCommand> commands(_batch_size);
+        std::vector<OrderRequest> requests(_batch_size);
+        std::vector<OrderResult> results(_batch_size);
+        for (;;)
+        {
+            auto count = _ingress.pop(commands.data(), commands.size());
+            if (count == 0)
+            {
+                if (!_stopping.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                // commands pushed before stop are processed first
+                count = _ingress.pop(commands.data(), commands.size());
+                if (count == 0)
+                    return;
+            }
+            auto dequeue_time = now();
+            for (size_t i = 0; i < count; ++i)
+                requests[i] = commands[i].request;
+            _book.add_orders(Span<const OrderRequest>(requests.data(), count), Span<OrderResult>(results.data(), count));
+            if (_observer != nullptr)
+                _observer->on_batch(_book);
+            auto done_time = now();
+            for (size_t i = 0; i < count; ++i)
+            {
+                PipelineResult result{results[i], commands[i].tag, commands[i].submit_time, dequeue_time, done_time};
+                while (!_outbound.try_push(result))
+                    std::this_thread::yield();
+            }
+        }
+    }
+
+    Book &_book;
+    Ingress _ingress;
+    SpscRing<PipelineResult> _outbound;
+    size_t _batch_size;
+    BookObserver *_observer = nullptr;
+    std::atomic<bool> _stopping{false};
+    std::thread _thread;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "order.hpp"
+
+/// @brief Operation of batch submitted to BasicOrderBook::add_orders
+struct OrderRequest
+{
+    enum class Action : uint8_t
+    {
+        Add,
+        Cancel,
+        Modify
+    };
+
+    Action action;
+    Order::Type type;             // Add
+    Order::IdType id;             // Cancel, Modify
+    Order::PriceType price;       // Add, Modify
+    Order::QuantityType quantity; // Add, Modify
+
+    static OrderRequest add(Order::Type type, Order::PriceType price, Order::QuantityType quantity)
+    {
+        return OrderRequest{Action::Add, type, 0, price, quantity};
+    }
+    static OrderRequest cancel(Order::IdType id)
+    {
+        return OrderRequest{Action::Cancel, Order::Type::Bid, id, 0, 0};
+    }
+    static OrderRequest modify(Order::IdType id, Order::PriceType price, Order::QuantityType quantity)
+    {
+        return OrderRequest{Action::Modify, Order::Type::Bid, id, price, quantity};
+    }
+};
+
+/// @brief Outcome of OrderRequest
+struct OrderResult
+{
+    enum class Status : uint8_t
+    {
+        Rested,   // order or its rest is placed to the book
+        Filled,   // order is fully executed
+        Canceled, // order is removed from the book
+        NotFound, // order to cancel or modify is not in the book
+        Rejected  // price is out of book price band
+    };
+
+    Status status;
+    Order::IdType id;                      // id of the order
+    Order::QuantityType executed_quantity; // executed part of added or modified order
+    uint32_t trade_count;                  // number of TradeEvent produced by request
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+#include "memory_resource.hpp"
+#include "order.hpp"
+
+/// @brief Fields of resting order read by matching loop. 16 bytes, so 4 records share cache line
+/// and sweep through level queue reads nothing else of the order.
+struct OrderNode
+{
+    using Index = uint32_t;
+
+    Order::IdType id;
+    Order::QuantityType quantity;
+    Index next; // next order of the level queue
+};
+
+/// @brief Fields of resting order used by cancel, modify and queries. Price and side of executed orders
+/// are known from their level and ladder, so matching doesn't read them.
+struct OrderNodeCold
+{
+    Order::PriceType price;
+    OrderNode::Index prev;  // previous order of the level queue, not maintained for the head of the queue
+    OrderNode::Index level; // index of PriceLevel in the ladder
+    Order::Type type;
+};
+
+static_assert(sizeof(OrderNode) == 16, "4 hot order records fit cache line");
+static_assert(sizeof(OrderNodeCold) == 16, "cold order record is compact");
+
+/// @brief Storage of resting orders addressed by 32 bit index, split into parallel arrays of
+/// hot and cold records.
+///
+/// Released slots are reused by next emplace, so orders don't move while they are alive
+/// and book structures can link them by index instead of pointer.
+/// Storage for capacity orders is allocated at construction.
+class OrderStore
+{
+public:
+    using Index = OrderNode::Index;
+    static constexpr Index null_index = UINT32_MAX;
+
+    explicit OrderStore(MemoryResource *resource = nullptr, size_t capacity = 0)
+        : _hot(BookAllocator<OrderNode>(resource)), _cold(BookAllocator<OrderNodeCold>(resource)),
+          _free(BookAllocator<Index>(resource))
+    {
+        reserve(capacity);
+    }
+
+    /// @brief make room for capacity orders, so that emplace doesn't reallocate storage
+    void reserve(size_t capacity)
+    {
+        _hot.reserve(capacity);
+        _cold.reserve(capacity);
+        _free.reserve(capacity);
+    }
+
+    /// @brief store order, its queue links are set by the ladder
+    Index emplace(const Order &order)
+    {
+        OrderNode hot{order.id(), order.quantity(), null_index};
+        OrderNodeCold cold{order.price(), null_index, null_index, order.type()};
+        if (_free.empty())
+        {
+            _hot.push_back(hot);
+            _cold.push_back(cold);
+            return static_cast<Index>(_hot.size() - 1);
+        }
+        auto index = _free.back();
+        _free.pop_back();
+        _hot[index] = hot;
+        _cold[index] = cold;
+        return index;
+    }
+    void release(Index index)
+    {
+        _free.push_back(index);
+    }
+
+    OrderNode &operator[](Index index) { return _hot[index]; }
+    const OrderNode &operator[](Index index) const { return _hot[index]; }
+    OrderNodeCold &cold(Index index) { return _cold[index]; }
+    const OrderNodeCold &cold(Index index) const { return _cold[index]; }
+
+    /// @brief copy of resting order assembled from its records
+    Order order(Index index) const
+    {
+        return Order(_cold[index].type, _cold[index].price, _hot[index].quantity, _hot[index].id);
+    }
+
+    size_t size() const { return _hot.size() - _free.size(); }
+    size_t capacity() const { return _hot.capacity(); }
+
+private:
+    std::vector<OrderNode, BookAllocator<OrderNode>> _hot;
+    std::vector<OrderNodeCold, BookAllocator<OrderNodeCold>> _cold;
+    std::vector<Index, BookAllocator<Index>> _free; // indexes of released slots
+};
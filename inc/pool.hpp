@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "memory_resource.hpp"
+
+/// @brief Storage of objects addressed by 32 bit index.
+///
+/// Released slots are reused by next emplace, so objects don't move while they are alive
+/// and book structures can link them by index instead of pointer.
+/// Storage for capacity objects is allocated at construction.
+template <typename T>
+class Pool
+{
+public:
+    using Index = uint32_t;
+    static constexpr Index null_index = UINT32_MAX;
+
+    explicit Pool(MemoryResource *resource = nullptr, size_t capacity = 0)
+        : _items(BookAllocator<T>(resource)), _free(BookAllocator<Index>(resource))
+    {
+        _items.reserve(capacity);
+        _free.reserve(capacity);
+    }
+
+    /// @brief make room for capacity objects, so that emplace doesn't reallocate storage
+    void reserve(size_t capacity)
+    {
+        _items.reserve(capacity);
+        _free.reserve(capacity);
+    }
+
+    template <typename... Args>
+    Index emplace(Args &&... args)
+    {
+        if (_free.empty())
+        {
+            _items.emplace_back(std::forward<Args>(args)...);
+            return static_cast<Index>(_items.size() - 1);
+        }
+        auto index = _free.back();
+        _free.pop_back();
+        _items[index] = T(std::forward<Args>(args)...);
+        return index;
+    }
+    void release(Index index)
+    {
+        _free.push_back(index);
+    }
+    T &operator[](Index index) { return _items[index]; }
+    const T &operator[](Index index) const { return _items[index]; }
+    size_t size() const { return _items.size() - _free.size(); }
+    size_t capacity() const { return _items.capacity(); }
+
+private:
+    std::vector<T, BookAllocator<T>> _items;
+    std::vector<Index, BookAllocator<Index>> _free; // indexes of released slots
+};
+
+template <typename T>
+constexpr typename Pool<T>::Index Pool<T>::null_index;
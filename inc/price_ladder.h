@@ -0,0 +1,197 @@
+#pragma once
+
+#include <vector>
+
+#include "hierarchical_bitset.hpp"
+#include "memory_resource.hpp"
+#include "order.hpp"
+#include "order_store.hpp"
+#include "pool.hpp"
+
+/// @brief All resting orders of one side with the same price
+struct PriceLevel
+{
+    explicit PriceLevel(Order::PriceType price) : price(price) {}
+
+    Order::PriceType price;
+    Order::QuantityType quantity = 0; // total quantity of orders in the level
+    OrderNode::Index head = OrderStore::null_index; // first order to execute
+    OrderNode::Index tail = OrderStore::null_index;
+    uint32_t order_count = 0; // number of orders in the level
+    bool changed = false; // level is in the list of changed prices
+};
+
+/// @brief Bounded price range of the book with dense level array
+struct PriceBand
+{
+    Order::PriceType min_price;
+    Order::PriceType max_price;
+    Order::PriceType tick_size = 1;
+
+    /// @brief Largest number of slots, each side of the book keeps dense array of that many levels
+    static constexpr size_t max_slots = size_t(1) << 22;
+
+    bool contains(Order::PriceType price) const
+    {
+        return price >= min_price && price <= max_price && offset(price) % tick_size == 0;
+    }
+    size_t slot(Order::PriceType price) const { return static_cast<size_t>(offset(price) / tick_size); }
+    size_t size() const { return slot(max_price) + 1; }
+
+private:
+    // wide bands overflow difference of prices in PriceType
+    int64_t offset(Order::PriceType price) const { return static_cast<int64_t>(price) - min_price; }
+};
+
+/// @brief Price levels of one side of the book sorted from the best price to the worst.
+///
+/// Orders are kept in the shared OrderStore, ladder only links them into level queues.
+///
+/// By default level lookup is binary search over sorted level list, the best level is the last one,
+/// so that levels near the top of the book are added and removed without moving others.
+/// If ladder is created with PriceBand, levels live in the flat array indexed by price slot
+/// and HierarchicalBitset of non-empty levels gives the best level and the next one.
+class PriceLadder
+{
+public:
+    using OrderPool = OrderStore;
+    using LevelIndex = Pool<PriceLevel>::Index;
+
+    /// @brief Position of level while walking the ladder from the best price
+    class Cursor
+    {
+    public:
+        bool valid() const { return _pos != 0; }
+
+    private:
+        friend class PriceLadder;
+        explicit Cursor(size_t pos) : _pos(pos) {}
+        size_t _pos; // 1 + position in _sorted_levels, or 1 + slot in dense mode
+    };
+
+    explicit PriceLadder(Order::Type side, const BookMemory &memory = BookMemory());
+    PriceLadder(Order::Type side, const PriceBand &band, const BookMemory &memory = BookMemory());
+
+    Order::Type side() const { return _side; }
+    bool dense() const { return _dense; }
+    /// @brief false if price can't be placed to the ladder
+    bool accepts(Order::PriceType price) const { return !_dense || _band.contains(price); }
+
+    bool empty() const { return _dense ? _non_empty_levels.empty() : _sorted_levels.empty(); }
+    LevelIndex best() const
+    {
+        if (_dense)
+            return static_cast<LevelIndex>(_side == Order::Type::Ask ? _non_empty_levels.find_first()
+                                                                     : _non_empty_levels.find_last());
+        return _sorted_levels.back();
+    }
+    PriceLevel &level(LevelIndex index) { return _levels[index]; }
+    const PriceLevel &level(LevelIndex index) const { return _levels[index]; }
+    size_t level_count() const { return _dense ? _dense_level_count : _sorted_levels.size(); }
+
+    Cursor first() const
+    {
+        if (_dense)
+            return empty() ? Cursor(0) : Cursor(best() + 1);
+        return Cursor(_sorted_levels.size());
+    }
+    void advance(Cursor &cursor) const
+    {
+        if (_dense)
+        {
+            auto slot = _side == Order::Type::Ask ? _non_empty_levels.find_next(cursor._pos - 1)
+                                                  : _non_empty_levels.find_prev(cursor._pos - 1);
+            cursor._pos = slot == HierarchicalBitset::npos ? 0 : slot + 1;
+        }
+        else
+            --cursor._pos;
+    }
+    const PriceLevel &level(Cursor cursor) const
+    {
+        return _levels[_dense ? cursor._pos - 1 : _sorted_levels[cursor._pos - 1]];
+    }
+
+    /// @brief level with given price, nullptr if there are no orders with this price
+    const PriceLevel *find(Order::PriceType price) const;
+
+    /// @brief prices of levels which quantity changed since the last clear_changes,
+    /// prices of removed levels are included
+    const std::vector<Order::PriceType, BookAllocator<Order::PriceType>> &changed_prices() const
+    {
+        return _changed_prices;
+    }
+    /// @brief true if there were more changes than changed_prices can hold, any level may be changed
+    bool changes_overflow() const { return _changes_overflow; }
+    void clear_changes();
+
+    /// @brief append order to the queue of its price level, creates level if needed
+    void push_back(OrderPool &orders, OrderNode::Index node_index);
+
+    /// @brief Append order to empty ladder built in priority order: the best price first, orders of
+    /// the same price in queue order. finish_load() has to be called after the last order.
+    ///
+    /// Levels are appended without search, so ladder of N orders is built in O(N).
+    void load_back(OrderPool &orders, OrderNode::Index node_index);
+    void finish_load();
+
+    /// @brief remove order from its level queue, removes level if it becomes empty
+    void unlink(OrderPool &orders, OrderNode::Index node_index)
+    {
+        unlink(orders, node_index, orders.cold(node_index).level);
+    }
+    void unlink(OrderPool &orders, OrderNode::Index node_index, LevelIndex level_index);
+
+    /// @brief execute part of resting order of given level, the rest keeps its place in the queue
+    Order split(OrderPool &orders, LevelIndex level_index, OrderNode::Index node_index, Order::QuantityType quantity)
+    {
+        auto &node = orders[node_index];
+        auto &level = _levels[level_index];
+        assert(quantity <= node.quantity);
+        node.quantity -= quantity;
+        level.quantity -= quantity;
+        mark_changed(level);
+        return Order(_side, level.price, quantity, node.id);
+    }
+
+    /// @brief decrease quantity of resting order, the order keeps its place in the queue
+    void reduce(OrderPool &orders, OrderNode::Index node_index, Order::QuantityType quantity)
+    {
+        auto &node = orders[node_index];
+        assert(quantity <= node.quantity);
+        auto &level = _levels[orders.cold(node_index).level];
+        level.quantity -= node.quantity - quantity;
+        mark_changed(level);
+        node.quantity = quantity;
+    }
+
+private:
+    bool worse(Order::PriceType p1, Order::PriceType p2) const
+    {
+        return _side == Order::Type::Ask ? p1 > p2 : p1 < p2;
+    }
+    std::vector<LevelIndex, BookAllocator<LevelIndex>>::const_iterator find_position(Order::PriceType price) const;
+    LevelIndex dense_level(Order::PriceType price); // marks level as non-empty
+    void link_back(OrderPool &orders, OrderNode::Index node_index, LevelIndex level_index);
+    void mark_changed(PriceLevel &level)
+    {
+        if (level.changed)
+            return;
+        level.changed = true;
+        if (_changed_prices.size() < _changed_prices.capacity())
+            _changed_prices.push_back(level.price);
+        else
+            _changes_overflow = true;
+    }
+
+    Order::Type _side;
+    Pool<PriceLevel> _levels;
+    std::vector<LevelIndex, BookAllocator<LevelIndex>> _sorted_levels; // from the worst price to the best one
+
+    bool _dense = false;
+    PriceBand _band{0, 0, 1};
+    HierarchicalBitset _non_empty_levels; // dense mode: bit per level slot
+    size_t _dense_level_count = 0;
+
+    std::vector<Order::PriceType, BookAllocator<Order::PriceType>> _changed_prices; // capacity is reserved once
+    bool _changes_overflow = false;
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/// @brief Size of cache line, counters written by different threads are kept this far apart
+constexpr size_t cache_line_size = 64;
+
+namespace ring_buffer_detail
+{
+inline size_t round_up_capacity(size_t capacity)
+{
+    size_t result = 2;
+    while (result < capacity)
+        result *= 2;
+    return result;
+}
+} // namespace ring_buffer_detail
+
+/// @brief Bounded lock-free queue for one producer thread and one consumer thread.
+///
+/// Each side keeps a copy of the other side's position and reloads it only when the ring looks
+/// full or empty, so in steady flow threads don't read each other's cache lines on every item.
+/// Capacity is rounded up to power of 2. T has to be default constructible and copyable.
+template <typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(size_t capacity)
+        : _capacity(ring_buffer_detail::round_up_capacity(capacity)), _items(new T[_capacity]) {}
+
+    size_t capacity() const { return _capacity; }
+
+    /// @brief returns false if ring is full, called by producer
+    bool try_push(const T &item)
+    {
+        auto tail = _producer.position.load(std::memory_order_relaxed);
+        if (tail - _producer.cached_other == _capacity)
+        {
+            _producer.cached_other = _consumer.position.load(std::memory_order_acquire);
+            if (tail - _producer.cached_other == _capacity)
+                return false;
+        }
+        _items[tail & (_capacity - 1)] = item;
+        _producer.position.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief returns false if ring is empty, called by consumer
+    bool try_pop(T &item) { return pop(&item, 1) == 1; }
+
+    /// @brief take up to count items, returns number of taken items, called by consumer
+    size_t pop(T *items, size_t count)
+    {
+        auto head = _consumer.position.load(std::memory_order_relaxed);
+        if (_consumer.cached_other - head < count)
+            _consumer.cached_other = _producer.position.load(std::memory_order_acquire);
+        auto available = _consumer.cached_other - head;
+        if (count > available)
+            count = available;
+        for (size_t i = 0; i < count; ++i)
+            items[i] = _items[(head + i) & (_capacity - 1)];
+        _consumer.position.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    struct Side
+    {
+        std::atomic<size_t> position{0}; // written by owner of the side
+        size_t cached_other = 0;         // last seen position of the other side
+        char padding[cache_line_size - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+    };
+
+    size_t _capacity;
+    std::unique_ptr<T[]> _items;
+    char _padding[cache_line_size];
+    Side _producer; // tail
+    Side _consumer; // head
+};
+
+/// @brief Bounded lock-free queue for many producer threads and one consumer thread.
+///
+/// Each slot has sequence number telling whether it is free for the producer of given position or
+/// filled for the consumer, so producers only contend on the tail counter with compare-exchange.
+/// Capacity is rounded up to power of 2. T has to be default constructible and copyable.
+template <typename T>
+class MpscRing
+{
+public:
+    explicit MpscRing(size_t capacity)
+        : _capacity(ring_buffer_detail::round_up_capacity(capacity)), _slots(new Slot[_capacity])
+    {
+        for (size_t i = 0; i < _capacity; ++i)
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return _capacity; }
+
+    /// @brief returns false if ring is full, can be called by any thread
+    bool try_push(const T &item)
+    {
+        auto tail = _tail.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto &slot = _slots[tail & (_capacity - 1)];
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::ptrdiff_t>(sequence - tail);
+            if (difference == 0) // slot is free for this position
+            {
+                if (_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+                {
+                    slot.item = item;
+                    slot.sequence.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0) // slot still holds item of previous round
+            {
+                return false;
+            }
+            else // other producer took the position
+            {
+                tail = _tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @brief returns false if ring is empty, called by consumer
+    bool try_pop(T &item) { return pop(&item, 1) == 1; }
+
+    /// @brief take up to count items, returns number of taken items, called by consumer
+    size_t pop(T *items, size_t count)
+    {
+        size_t taken = 0;
+        for (; taken < count; ++taken, ++_head)
+        {
+            auto &slot = _slots[_head & (_capacity - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != _head + 1)
+                break; // not filled yet
+            items[taken] = slot.item;
+            slot.sequence.store(_head + _capacity, std::memory_order_release);
+        }
+        return taken;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    size_t _capacity;
+    std::unique_ptr<Slot[]> _slots;
+    char _padding[cache_line_size];
+    std::atomic<size_t> _tail{0};
+    char _tail_padding[cache_line_size - sizeof(std::atomic<size_t>)];
+    size_t _head = 0; // used only by consumer
+};
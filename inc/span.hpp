@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+/// @brief View of contiguous sequence of objects, subset of C++20 std::span
+template <typename T>
+class Span
+{
+public:
+    Span() = default;
+    Span(T *data, size_t size) : _data(data), _size(size) {}
+    template <size_t N>
+    Span(T (&array)[N]) : _data(array), _size(N) {}
+    template <typename U, size_t N, typename = typename std::enable_if<std::is_convertible<U (*)[], T (*)[]>::value>::type>
+    Span(std::array<U, N> &array) : _data(array.data()), _size(N) {}
+    template <typename U, size_t N, typename = typename std::enable_if<std::is_convertible<const U (*)[], T (*)[]>::value>::type>
+    Span(const std::array<U, N> &array) : _data(array.data()), _size(N) {}
+    template <typename U, typename A, typename = typename std::enable_if<std::is_convertible<U (*)[], T (*)[]>::value>::type>
+    Span(std::vector<U, A> &vector) : _data(vector.data()), _size(vector.size()) {}
+    template <typename U, typename A, typename = typename std::enable_if<std::is_convertible<const U (*)[], T (*)[]>::value>::type>
+    Span(const std::vector<U, A> &vector) : _data(vector.data()), _size(vector.size()) {}
+
+    T *data() const { return _data; }
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    T &operator[](size_t index) const { return _data[index]; }
+    T *begin() const { return _data; }
+    T *end() const { return _data + _size; }
+    Span subspan(size_t offset, size_t count) const { return Span(_data + offset, count); }
+
+private:
+    T *_data = nullptr;
+    size_t _size = 0;
+};
@@ -0,0 +1,8 @@
+#pragma once
+#include <cstddef>
+#include <thread>
+
+/// @brief Bind thread to one core, core number is taken modulo number of cores.
+///
+/// @return false if binding is not supported or not allowed
+bool pin_thread_to_core(std::thread &thread, size_t core);
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <type_traits>
+
+#include "order.hpp"
+
+/// @brief Report of one match between resting (maker) and incoming (taker) orders
+struct TradeEvent
+{
+    uint64_t sequence; // number of the trade in the book, starts from 1
+    Order::IdType maker_id;
+    Order::IdType taker_id;
+    Order::PriceType price;
+    Order::QuantityType quantity;
+    Order::QuantityType maker_remaining; // quantity left in the book, 0 means maker order is done
+    Order::QuantityType taker_remaining; // quantity of incoming order still not executed
+    Order::Type aggressor;               // type of incoming order
+};
+
+static_assert(std::is_trivial<TradeEvent>::value && std::is_standard_layout<TradeEvent>::value,
+              "TradeEvent is copied as raw bytes");
@@ -0,0 +1,49 @@
+#include "binary_market_data.h"
+
+#include <algorithm>
+
+namespace
+{
+size_t limited_count(size_t level_count, int order_limit)
+{
+    return order_limit < 0 ? level_count : std::min(level_count, static_cast<size_t>(order_limit));
+}
+} // namespace
+
+size_t OrderBookBase::depth_binary_size(int bid_order_limit /*= -1*/, int ask_order_limit /*= -1*/) const
+{
+    return binary_market_data::header_size +
+           binary_market_data::level_size * (limited_count(_ask_ladder.level_count(), ask_order_limit) +
+                                             limited_count(_bid_ladder.level_count(), bid_order_limit));
+}
+
+size_t OrderBookBase::depth_binary(uint64_t sequence, Span<uint8_t> buffer, int bid_order_limit /*= -1*/,
+                                   int ask_order_limit /*= -1*/) const
+{
+    auto size = depth_binary_size(bid_order_limit, ask_order_limit);
+    if (buffer.size() < size)
+        return 0;
+    binary_market_data::Header header;
+    header.sequence = sequence;
+    header.ask_count = static_cast<uint32_t>(limited_count(_ask_ladder.level_count(), ask_order_limit));
+    header.bid_count = static_cast<uint32_t>(limited_count(_bid_ladder.level_count(), bid_order_limit));
+    header.last_price = _last_price;
+    header.last_quantity = _last_quantity;
+    header.flags = _transactions_started ? binary_market_data::has_last_trade_flag : 0;
+    binary_market_data::write_header(buffer.data(), header);
+
+    auto *out = buffer.data() + binary_market_data::header_size;
+    for (auto type : {Order::Type::Ask, Order::Type::Bid})
+    {
+        auto count = type == Order::Type::Ask ? header.ask_count : header.bid_count;
+        auto aggregator = make_price_aggregator(type);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            auto price_position_pair = aggregator.next_price();
+            assert(price_position_pair.first);
+            binary_market_data::write_level(out, price_position_pair.second);
+            out += binary_market_data::level_size;
+        }
+    }
+    return size;
+}
@@ -0,0 +1,280 @@
+#include "book_snapshot.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "little_endian.hpp"
+#include "order_book_base.h"
+
+namespace
+{
+const uint32_t snapshot_magic = 0x3153424f; // "OBS1"
+const size_t write_buffer_size = 64 * 1024;
+
+OrderBookBase::Exception io_error(const std::string &action, const std::string &path)
+{
+    return OrderBookBase::Exception("Snapshot " + path + " " + action + " failed: " + std::strerror(errno));
+}
+
+/// @brief Buffers writes to temporary file which replaces file at path on commit.
+///
+/// Crash or error before commit leaves the previous snapshot at path intact.
+class SnapshotFile
+{
+public:
+    SnapshotFile(const std::string &path) : _path(path), _temp_path(path + ".tmp")
+    {
+        _buffer.reserve(write_buffer_size);
+        _file = ::open(_temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (_file < 0)
+            throw io_error("open", _temp_path);
+    }
+    ~SnapshotFile()
+    {
+        if (_file >= 0)
+            ::close(_file);
+        if (!_committed)
+            ::unlink(_temp_path.c_str());
+    }
+    SnapshotFile(const SnapshotFile &) = delete;
+    SnapshotFile &operator=(const SnapshotFile &) = delete;
+
+    uint8_t *reserve(size_t size)
+    {
+        if (_buffer.size() + size > write_buffer_size)
+            flush();
+        _buffer.resize(_buffer.size() + size);
+        return _buffer.data() + _buffer.size() - size;
+    }
+
+    void flush()
+    {
+        const uint8_t *data = _buffer.data();
+        auto size = _buffer.size();
+        while (size > 0)
+        {
+            auto written = ::write(_file, data, size);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw io_error("write", _temp_path);
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        _buffer.clear();
+    }
+
+    /// @brief write buffered data, sync it to disk and rename temporary file over the snapshot
+    void commit()
+    {
+        flush();
+        if (::fsync(_file) != 0)
+            throw io_error("sync", _temp_path);
+        auto file = _file;
+        _file = -1;
+        if (::close(file) != 0)
+            throw io_error("close", _temp_path);
+        if (::rename(_temp_path.c_str(), _path.c_str()) != 0)
+            throw io_error("rename", _temp_path);
+        _committed = true;
+        sync_directory();
+    }
+
+private:
+    // makes rename durable, failure leaves either snapshot valid, so it isn't reported
+    void sync_directory() const
+    {
+        auto slash = _path.rfind('/');
+        auto directory = slash == std::string::npos ? std::string(".") : _path.substr(0, slash == 0 ? 1 : slash);
+        auto file = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (file < 0)
+            return;
+        ::fsync(file);
+        ::close(file);
+    }
+
+    std::string _path;
+    std::string _temp_path;
+    bool _committed = false;
+    int _file = -1;
+    std::vector<uint8_t> _buffer;
+};
+
+/// @brief read-only private mapping of the whole file
+class MappedFile
+{
+public:
+    MappedFile(const std::string &path)
+    {
+        auto file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0)
+            throw io_error("open", path);
+        struct stat status;
+        if (::fstat(file, &status) != 0)
+        {
+            auto error = io_error("stat", path);
+            ::close(file);
+            throw error;
+        }
+        _size = static_cast<size_t>(status.st_size);
+        if (_size > 0)
+        {
+            void *data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (data == MAP_FAILED)
+            {
+                auto error = io_error("mmap", path);
+                ::close(file);
+                throw error;
+            }
+            _data = static_cast<const uint8_t *>(data);
+            ::madvise(data, _size, MADV_SEQUENTIAL);
+        }
+        ::close(file);
+    }
+    ~MappedFile()
+    {
+        if (_data != nullptr)
+            ::munmap(const_cast<uint8_t *>(_data), _size);
+    }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const uint8_t *data() const { return _data; }
+    size_t size() const { return _size; }
+
+private:
+    const uint8_t *_data = nullptr;
+    size_t _size = 0;
+};
+
+/// @brief orders of one side stored in the mapped snapshot
+class SnapshotSide
+{
+public:
+    SnapshotSide(Order::Type type, const uint8_t *records, size_t count)
+        : _type(type), _records(records), _count(count) {}
+
+    size_t size() const { return _count; }
+    Order::PriceType price(size_t i) const
+    {
+        return static_cast<Order::PriceType>(little_endian::read_u32(record(i) + 8));
+    }
+    Order::QuantityType quantity(size_t i) const { return little_endian::read_u32(record(i) + 12); }
+    Order::IdType id(size_t i) const { return little_endian::read_u64(record(i)); }
+    Order order(size_t i) const { return Order(_type, price(i), quantity(i), id(i)); }
+
+private:
+    const uint8_t *record(size_t i) const { return _records + i * book_snapshot::record_size; }
+
+    Order::Type _type;
+    const uint8_t *_records;
+    size_t _count;
+};
+} // namespace
+
+void OrderBookBase::save_snapshot(const std::string &path) const
+{
+    SnapshotFile file(path);
+    auto header = file.reserve(book_snapshot::header_size);
+    std::memset(header, 0, book_snapshot::header_size);
+    little_endian::write_u32(header, snapshot_magic);
+    little_endian::write_u32(header + 4, book_snapshot::record_size);
+    uint64_t ask_count = 0;
+    for (auto cursor = _ask_ladder.first(); cursor.valid(); _ask_ladder.advance(cursor))
+        ask_count += _ask_ladder.level(cursor).order_count;
+    little_endian::write_u64(header + 8, ask_count);
+    little_endian::write_u64(header + 16, _orders.size() - ask_count);
+    little_endian::write_u32(header + 24, static_cast<uint32_t>(_last_price));
+    little_endian::write_u32(header + 28, _last_quantity);
+    uint32_t flags = 0;
+    if (_transactions_started)
+        flags |= book_snapshot::has_last_trade_flag;
+    if (_id_source == nullptr)
+        flags |= book_snapshot::own_ids_flag;
+    little_endian::write_u32(header + 32, flags);
+    little_endian::write_u64(header + 40, _trade_sequence);
+    little_endian::write_u64(header + 48, _next_id);
+    little_endian::write_u64(header + 56, _end_id);
+    for (const auto *ladder : {&_ask_ladder, &_bid_ladder})
+    {
+        for (auto cursor = ladder->first(); cursor.valid(); ladder->advance(cursor))
+        {
+            for (auto node_index = ladder->level(cursor).head; node_index != OrderStore::null_index;
+                 node_index = _orders[node_index].next)
+            {
+                const auto order = _orders.order(node_index);
+                auto record = file.reserve(book_snapshot::record_size);
+                little_endian::write_u64(record, order.id());
+                little_endian::write_u32(record + 8, static_cast<uint32_t>(order.price()));
+                little_endian::write_u32(record + 12, order.quantity());
+            }
+        }
+    }
+    file.commit();
+}
+
+void OrderBookBase::load_snapshot(const std::string &path)
+{
+    MappedFile file(path);
+    const auto *header = file.data();
+    if (file.size() < book_snapshot::header_size || little_endian::read_u32(header) != snapshot_magic ||
+        little_endian::read_u32(header + 4) != book_snapshot::record_size)
+        throw OrderBookBase::Exception("Snapshot " + path + " has invalid header");
+    auto ask_count = little_endian::read_u64(header + 8);
+    auto bid_count = little_endian::read_u64(header + 16);
+    auto record_count = (file.size() - book_snapshot::header_size) / book_snapshot::record_size;
+    if (ask_count > record_count || bid_count != record_count - ask_count ||
+        (file.size() - book_snapshot::header_size) % book_snapshot::record_size != 0)
+        throw OrderBookBase::Exception("Snapshot " + path + " size doesn't match number of orders");
+    auto flags = little_endian::read_u32(header + 32);
+    auto own_ids = (flags & book_snapshot::own_ids_flag) != 0;
+    IdBlock ids{little_endian::read_u64(header + 48), little_endian::read_u64(header + 56)};
+    const auto *records = header + book_snapshot::header_size;
+    SnapshotSide asks(Order::Type::Ask, records, ask_count);
+    SnapshotSide bids(Order::Type::Bid, records + ask_count * book_snapshot::record_size, bid_count);
+
+    // everything is checked before id source skips ids, so rejected snapshot doesn't change it
+    check_bulk_load(asks, bids);
+    // ids of loaded orders and ids the saved book has given are never given again
+    auto last_id = check_bulk_ids(asks, bids);
+    if (ids.first != 0)
+        last_id = std::max(last_id, ids.first - 1);
+    if (own_ids)
+    {
+        if (ids.first > ids.end || ids.first <= last_id)
+            throw OrderBookBase::Exception("Snapshot " + path + " has invalid id range");
+    }
+    else if (_id_source == nullptr)
+    {
+        if (_next_id <= last_id)
+            throw OrderBookBase::Exception("Ids of the book collide with ids of snapshot " + path);
+    }
+    else if (!_id_source->reserve_through(last_id))
+    {
+        throw OrderBookBase::Exception("Id source of the book can't skip ids of snapshot " + path);
+    }
+
+    bulk_load(asks, bids);
+    _transactions_started = (flags & book_snapshot::has_last_trade_flag) != 0;
+    _last_price = static_cast<Order::PriceType>(little_endian::read_u32(header + 24));
+    _last_quantity = little_endian::read_u32(header + 28);
+    _trade_sequence = little_endian::read_u64(header + 40);
+    if (own_ids)
+    {
+        set_id_block(ids);
+        IdSource::reserve_prefix(static_cast<uint32_t>(ids.first >> IdSource::counter_bits));
+    }
+    else if (_id_source != nullptr)
+    {
+        _next_id = _end_id = 0; // the next id is taken from source after skipped ones
+    }
+}
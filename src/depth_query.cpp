@@ -0,0 +1,218 @@
+#include "depth_query.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DEPTH_QUERY_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+// levels scanned linearly from the best price before binary search, most queries end within them
+constexpr size_t linear_levels = 64;
+
+// Kernels return position of the first value greater than limit among size values, or size if there
+// is none. Size is a multiple of 8.
+template <typename T>
+size_t scalar_find_above(const T *values, size_t size, T limit)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (values[i] > limit)
+            return i;
+    }
+    return size;
+}
+
+#ifdef DEPTH_QUERY_X86
+__attribute__((target("sse4.2"))) size_t sse42_find_above(const int32_t *values, size_t size, int32_t limit)
+{
+    auto limits = _mm_set1_epi32(limit);
+    for (size_t i = 0; i < size; i += 4)
+    {
+        auto greater = _mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i)), limits);
+        auto mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(greater)));
+        if (mask != 0)
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    return size;
+}
+
+__attribute__((target("sse4.2"))) size_t sse42_find_above(const int64_t *values, size_t size, int64_t limit)
+{
+    auto limits = _mm_set1_epi64x(limit);
+    for (size_t i = 0; i < size; i += 2)
+    {
+        auto greater = _mm_cmpgt_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i)), limits);
+        auto mask = static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(greater)));
+        if (mask != 0)
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    return size;
+}
+
+__attribute__((target("avx2"))) size_t avx2_find_above(const int32_t *values, size_t size, int32_t limit)
+{
+    auto limits = _mm256_set1_epi32(limit);
+    for (size_t i = 0; i < size; i += 8)
+    {
+        auto greater = _mm256_cmpgt_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i)), limits);
+        auto mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(greater)));
+        if (mask != 0)
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    return size;
+}
+
+__attribute__((target("avx2"))) size_t avx2_find_above(const int64_t *values, size_t size, int64_t limit)
+{
+    auto limits = _mm256_set1_epi64x(limit);
+    for (size_t i = 0; i < size; i += 4)
+    {
+        auto greater = _mm256_cmpgt_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i)), limits);
+        auto mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(greater)));
+        if (mask != 0)
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    return size;
+}
+#endif
+
+// number of leading values not greater than limit, values are sorted and padded by values greater than limit
+template <typename T>
+size_t count_not_above(const T *values, size_t size, T limit, size_t (*find_above)(const T *, size_t, T))
+{
+    auto padded_size = (size + 7) / 8 * 8;
+    auto window = std::min(padded_size, linear_levels);
+    auto position = find_above(values, window, limit);
+    if (position < window)
+        return position;
+    return static_cast<size_t>(std::upper_bound(values + window, values + size, limit) - values);
+}
+} // namespace
+
+DepthQuery::DepthQuery(size_t max_levels /*= 1024*/, SimdLevel simd_level /*= SimdLevel::Avx2*/)
+    : _max_levels(max_levels), _simd_level(std::min(simd_level, supported_simd_level())),
+      _find_above_32(scalar_find_above<int32_t>), _find_above_64(scalar_find_above<int64_t>)
+{
+#ifdef DEPTH_QUERY_X86
+    if (_simd_level == SimdLevel::Avx2)
+    {
+        _find_above_32 = avx2_find_above;
+        _find_above_64 = avx2_find_above;
+    }
+    else if (_simd_level == SimdLevel::Sse42)
+    {
+        _find_above_32 = sse42_find_above;
+        _find_above_64 = sse42_find_above;
+    }
+#endif
+    auto capacity = (max_levels + simd_block - 1) / simd_block * simd_block + simd_block;
+    for (auto *side : {&_asks, &_bids})
+    {
+        side->prices.resize(capacity);
+        side->distances.resize(capacity, std::numeric_limits<int32_t>::max());
+        side->quantities.resize(capacity, std::numeric_limits<int64_t>::max());
+        side->notionals.resize(capacity);
+    }
+}
+
+DepthQuery::SimdLevel DepthQuery::supported_simd_level()
+{
+    static const SimdLevel level = [] {
+#ifdef DEPTH_QUERY_X86
+        if (__builtin_cpu_supports("avx2"))
+            return SimdLevel::Avx2;
+        if (__builtin_cpu_supports("sse4.2"))
+            return SimdLevel::Sse42;
+#endif
+        return SimdLevel::Scalar;
+    }();
+    return level;
+}
+
+void DepthQuery::update(const OrderBookBase &book)
+{
+    update_side(book._ask_ladder, _asks);
+    update_side(book._bid_ladder, _bids);
+}
+
+void DepthQuery::update_side(const PriceLadder &ladder, Side &side)
+{
+    side.size = 0;
+    for (auto cursor = ladder.first(); cursor.valid() && side.size < _max_levels; ladder.advance(cursor))
+    {
+        const auto &level = ladder.level(cursor);
+        append_level(side, level.price, level.quantity);
+    }
+    finish_side(side);
+}
+
+void DepthQuery::update_side(Span<const BookLevel> levels, Side &side)
+{
+    side.size = 0;
+    for (size_t i = 0; i < levels.size() && side.size < _max_levels; ++i)
+        append_level(side, levels[i].price, levels[i].quantity);
+    finish_side(side);
+}
+
+void DepthQuery::append_level(Side &side, Order::PriceType price, Order::QuantityType quantity)
+{
+    auto i = side.size++;
+    auto distance = i == 0 ? 0 : std::abs(static_cast<int64_t>(price) - side.prices[0]);
+    side.prices[i] = price;
+    side.distances[i] = static_cast<int32_t>(std::min<int64_t>(distance, std::numeric_limits<int32_t>::max() - 1));
+    side.quantities[i] = (i == 0 ? 0 : side.quantities[i - 1]) + quantity;
+    side.notionals[i] = (i == 0 ? 0 : side.notionals[i - 1]) + static_cast<int64_t>(price) * quantity;
+}
+
+// padding stops scans at the end of levels
+void DepthQuery::finish_side(Side &side)
+{
+    for (size_t i = side.size; i < side.size + simd_block; ++i)
+    {
+        side.distances[i] = std::numeric_limits<int32_t>::max();
+        side.quantities[i] = std::numeric_limits<int64_t>::max();
+    }
+}
+
+uint64_t DepthQuery::quantity_within(Order::Type type, Order::PriceType distance) const
+{
+    const auto &levels = side(type);
+    if (levels.size == 0 || distance < 0)
+        return 0;
+    auto limit = std::min(distance, std::numeric_limits<int32_t>::max() - 1);
+    auto count = count_not_above(levels.distances.data(), levels.size, limit, _find_above_32);
+    return static_cast<uint64_t>(levels.quantities[count - 1]); // the best level is at distance 0
+}
+
+FillEstimate DepthQuery::fill(Order::Type type, uint64_t quantity) const
+{
+    FillEstimate estimate;
+    const auto &levels = side(type);
+    if (levels.size == 0 || quantity == 0)
+        return estimate;
+    auto limit = static_cast<int64_t>(
+        std::min<uint64_t>(quantity, static_cast<uint64_t>(std::numeric_limits<int64_t>::max() - 1)));
+    // levels filled completely have cumulative quantity below requested one
+    auto count = count_not_above(levels.quantities.data(), levels.size, limit - 1, _find_above_64);
+    if (count == levels.size)
+    {
+        estimate.quantity = static_cast<uint64_t>(levels.quantities[count - 1]);
+        estimate.notional = levels.notionals[count - 1];
+        estimate.worst_price = levels.prices[count - 1];
+        estimate.levels = static_cast<uint32_t>(count);
+        return estimate;
+    }
+    auto filled = count == 0 ? 0 : levels.quantities[count - 1];
+    auto notional = count == 0 ? 0 : levels.notionals[count - 1];
+    estimate.quantity = quantity;
+    estimate.notional = notional + (limit - filled) * levels.prices[count];
+    estimate.worst_price = levels.prices[count];
+    estimate.levels = static_cast<uint32_t>(count + 1);
+    estimate.complete = true;
+    return estimate;
+}
@@ -0,0 +1,65 @@
+#include "id_source.hpp"
+
+#include <algorithm>
+
+#include "order_book_base.h"
+
+namespace
+{
+std::atomic<uint32_t> last_prefix{0};
+} // namespace
+
+IdSource *IdSource::shared()
+{
+    static BlockIdSource source;
+    return &source;
+}
+
+uint32_t IdSource::allocate_prefix()
+{
+    return last_prefix.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+void IdSource::reserve_prefix(uint32_t prefix)
+{
+    auto last = last_prefix.load(std::memory_order_relaxed);
+    while (last < prefix && !last_prefix.compare_exchange_weak(last, prefix, std::memory_order_relaxed))
+    {
+    }
+}
+
+IdBlock BlockIdSource::allocate_block()
+{
+    const auto end = prefix_block(0).end;
+    auto first = _next.load(std::memory_order_relaxed);
+    Order::IdType next;
+    do
+    {
+        if (first >= end)
+            throw OrderBookBase::Exception("Order ids of the shared id source are exhausted");
+        next = first + std::min<Order::IdType>(_block_size, end - first); // the last block may be shorter
+    } while (!_next.compare_exchange_weak(first, next, std::memory_order_relaxed));
+    return IdBlock{first, next};
+}
+
+bool BlockIdSource::reserve_through(Order::IdType last_id)
+{
+    if (last_id >= prefix_block(0).end)
+        return false;
+    auto next = _next.load(std::memory_order_relaxed);
+    while (next <= last_id && !_next.compare_exchange_weak(next, last_id + 1, std::memory_order_relaxed))
+    {
+    }
+    return true;
+}
+
+IdBlock ThreadIdSource::allocate_block()
+{
+    thread_local IdBlock thread_ids{0, 0};
+    if (thread_ids.first == thread_ids.end)
+        thread_ids = prefix_block(allocate_prefix());
+    auto end = std::min<Order::IdType>(thread_ids.first + _block_size, thread_ids.end);
+    IdBlock block{thread_ids.first, end};
+    thread_ids.first = end;
+    return block;
+}
@@ -0,0 +1,179 @@
+#include "journal.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "little_endian.hpp"
+
+namespace
+{
+const uint32_t journal_magic = 0x314a424f; // "OBJ1"
+
+OrderBookBase::Exception io_error(const std::string &action, const std::string &path)
+{
+    return OrderBookBase::Exception("Journal " + path + " " + action + " failed: " + std::strerror(errno));
+}
+
+void write_all(int file, const std::string &path, const uint8_t *data, size_t size)
+{
+    while (size > 0)
+    {
+        auto written = ::write(file, data, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw io_error("write", path);
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+void encode_record(uint8_t *out, uint64_t sequence, const OrderRequest &request)
+{
+    little_endian::write_u64(out, sequence);
+    little_endian::write_u64(out + 8, request.id);
+    little_endian::write_u32(out + 16, static_cast<uint32_t>(request.price));
+    little_endian::write_u32(out + 20, request.quantity);
+    out[24] = static_cast<uint8_t>(request.action);
+    out[25] = static_cast<uint8_t>(request.type);
+    std::memset(out + 26, 0, journal::record_size - 26);
+}
+} // namespace
+
+JournalWriter::JournalWriter(const std::string &path, const OrderBookBase &book, size_t fsync_group /*= 1024*/,
+                             size_t buffer_size /*= 64 * 1024*/)
+    : _path(path), _buffer(std::max(buffer_size, journal::record_size)), _fsync_group(fsync_group)
+{
+    if (book.id_source() != nullptr)
+        throw OrderBookBase::Exception("Journaled book has to count its ids itself");
+    _file = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (_file < 0)
+        throw io_error("open", path);
+    uint8_t header[journal::header_size] = {};
+    little_endian::write_u32(header, journal_magic);
+    little_endian::write_u32(header + 4, journal::record_size);
+    little_endian::write_u64(header + 8, book.id_block().first);
+    little_endian::write_u64(header + 16, book.id_block().end);
+    try
+    {
+        write_all(_file, _path, header, sizeof(header));
+    }
+    catch (...)
+    {
+        ::close(_file);
+        throw;
+    }
+}
+
+JournalWriter::~JournalWriter()
+{
+    try
+    {
+        sync();
+    }
+    catch (const OrderBookBase::Exception &)
+    {
+    }
+    ::close(_file);
+}
+
+void JournalWriter::append(const OrderRequest &request)
+{
+    if (_buffer.size() - _buffer_used < journal::record_size)
+        flush();
+    encode_record(_buffer.data() + _buffer_used, ++_sequence, request);
+    _buffer_used += journal::record_size;
+    if (_fsync_group != 0 && ++_unsynced >= _fsync_group)
+        sync();
+}
+
+void JournalWriter::flush()
+{
+    write_all(_file, _path, _buffer.data(), _buffer_used);
+    _buffer_used = 0;
+}
+
+void JournalWriter::sync()
+{
+    flush();
+    if (::fdatasync(_file) != 0)
+        throw io_error("sync", _path);
+    _unsynced = 0;
+}
+
+JournalReader::JournalReader(const std::string &path, size_t buffer_size /*= 1024 * 1024*/)
+    : _path(path), _buffer(std::max(buffer_size, journal::header_size))
+{
+    _file = ::open(path.c_str(), O_RDONLY);
+    if (_file < 0)
+        throw io_error("open", path);
+    if (!fill_buffer() || _buffer_end < journal::header_size ||
+        little_endian::read_u32(_buffer.data()) != journal_magic ||
+        little_endian::read_u32(_buffer.data() + 4) != journal::record_size)
+    {
+        ::close(_file);
+        throw OrderBookBase::Exception("Journal " + path + " has wrong header");
+    }
+    _ids.first = little_endian::read_u64(_buffer.data() + 8);
+    _ids.end = little_endian::read_u64(_buffer.data() + 16);
+    _buffer_begin = journal::header_size;
+}
+
+JournalReader::~JournalReader()
+{
+    ::close(_file);
+}
+
+// moves unread bytes to the beginning of the buffer and reads file after them
+bool JournalReader::fill_buffer()
+{
+    std::memmove(_buffer.data(), _buffer.data() + _buffer_begin, _buffer_end - _buffer_begin);
+    _buffer_end -= _buffer_begin;
+    _buffer_begin = 0;
+    while (!_end_of_file && _buffer_end < _buffer.size())
+    {
+        auto read = ::read(_file, _buffer.data() + _buffer_end, _buffer.size() - _buffer_end);
+        if (read < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw io_error("read", _path);
+        }
+        if (read == 0)
+            _end_of_file = true;
+        _buffer_end += static_cast<size_t>(read);
+    }
+    return _buffer_end > 0;
+}
+
+size_t JournalReader::read(Span<OrderRequest> requests)
+{
+    size_t count = 0;
+    while (count < requests.size())
+    {
+        if (_buffer_end - _buffer_begin < journal::record_size)
+        {
+            if (_end_of_file || !fill_buffer() || _buffer_end - _buffer_begin < journal::record_size)
+                break;
+        }
+        const auto *record = _buffer.data() + _buffer_begin;
+        if (little_endian::read_u64(record) != _sequence + 1 ||
+            record[24] > static_cast<uint8_t>(OrderRequest::Action::Modify) ||
+            record[25] > static_cast<uint8_t>(Order::Type::Bid))
+            throw OrderBookBase::Exception("Journal record " + std::to_string(_sequence + 1) + " is broken");
+        ++_sequence;
+        auto &request = requests[count++];
+        request.id = little_endian::read_u64(record + 8);
+        request.price = static_cast<Order::PriceType>(little_endian::read_u32(record + 16));
+        request.quantity = little_endian::read_u32(record + 20);
+        request.action = static_cast<OrderRequest::Action>(record[24]);
+        request.type = static_cast<Order::Type>(record[25]);
+        _buffer_begin += journal::record_size;
+    }
+    return count;
+}
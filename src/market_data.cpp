@@ -0,0 +1,130 @@
+#include "market_data.h"
+
+#include <algorithm>
+
+namespace
+{
+using PublishedLevel = std::pair<Order::PriceType, Order::QuantityType>;
+
+bool price_less(const PublishedLevel &level, Order::PriceType price)
+{
+    return level.first < price;
+}
+} // namespace
+
+MarketDataPublisher::MarketDataPublisher(OrderBookBase &book)
+    : _book(book), _trade_sequence(book._trade_sequence)
+{
+}
+
+MarketDataHeader MarketDataPublisher::publish(std::vector<LevelUpdate> &updates)
+{
+    auto updates_size = updates.size();
+    if (_synchronized)
+    {
+        publish_changes(_book._ask_ladder, _published_asks, updates);
+        publish_changes(_book._bid_ladder, _published_bids, updates);
+    }
+    else // levels placed before publisher was created are not tracked as changes
+    {
+        publish_all(_book._ask_ladder, _published_asks, updates);
+        publish_all(_book._bid_ladder, _published_bids, updates);
+        _synchronized = true;
+    }
+    _book._ask_ladder.clear_changes();
+    _book._bid_ladder.clear_changes();
+
+    bool trade_updated = _trade_sequence != _book._trade_sequence;
+    _trade_sequence = _book._trade_sequence;
+    if (trade_updated || updates.size() != updates_size)
+        ++_sequence;
+    return header(trade_updated);
+}
+
+MarketDataHeader MarketDataPublisher::snapshot(std::vector<LevelUpdate> &levels) const
+{
+    for (const auto &level : _published_asks) // the lowest ask is the best
+        levels.push_back(LevelUpdate{LevelUpdate::Action::New, Order::Type::Ask, level.first, level.second});
+    for (auto level = _published_bids.rbegin(); level != _published_bids.rend(); ++level)
+        levels.push_back(LevelUpdate{LevelUpdate::Action::New, Order::Type::Bid, level->first, level->second});
+    return header(false);
+}
+
+void MarketDataPublisher::publish_changes(PriceLadder &ladder, PublishedLevels &published,
+                                          std::vector<LevelUpdate> &updates)
+{
+    if (ladder.changes_overflow())
+    {
+        publish_all(ladder, published, updates);
+        return;
+    }
+    // the same price may be listed twice if its level was removed and created again
+    for (auto price : ladder.changed_prices())
+    {
+        const auto *level = ladder.find(price);
+        auto quantity = level == nullptr ? 0 : level->quantity;
+        auto pos = std::lower_bound(published.begin(), published.end(), price, price_less);
+        bool was_published = pos != published.end() && pos->first == price;
+        if (!was_published)
+        {
+            if (quantity == 0)
+                continue;
+            published.insert(pos, PublishedLevel(price, quantity));
+            updates.push_back(LevelUpdate{LevelUpdate::Action::New, ladder.side(), price, quantity});
+        }
+        else if (quantity == 0)
+        {
+            published.erase(pos);
+            updates.push_back(LevelUpdate{LevelUpdate::Action::Delete, ladder.side(), price, 0});
+        }
+        else if (pos->second != quantity)
+        {
+            pos->second = quantity;
+            updates.push_back(LevelUpdate{LevelUpdate::Action::Change, ladder.side(), price, quantity});
+        }
+    }
+}
+
+void MarketDataPublisher::publish_all(PriceLadder &ladder, PublishedLevels &published,
+                                      std::vector<LevelUpdate> &updates)
+{
+    PublishedLevels current;
+    for (auto cursor = ladder.first(); cursor.valid(); ladder.advance(cursor))
+    {
+        const auto &level = ladder.level(cursor);
+        current.emplace_back(level.price, level.quantity);
+    }
+    if (ladder.side() == Order::Type::Bid) // bids are walked from the highest price
+        std::reverse(current.begin(), current.end());
+
+    auto side = ladder.side();
+    auto old_level = published.begin();
+    auto new_level = current.begin();
+    while (old_level != published.end() || new_level != current.end())
+    {
+        if (new_level == current.end() || (old_level != published.end() && old_level->first < new_level->first))
+        {
+            updates.push_back(LevelUpdate{LevelUpdate::Action::Delete, side, old_level->first, 0});
+            ++old_level;
+        }
+        else if (old_level == published.end() || new_level->first < old_level->first)
+        {
+            updates.push_back(LevelUpdate{LevelUpdate::Action::New, side, new_level->first, new_level->second});
+            ++new_level;
+        }
+        else
+        {
+            if (old_level->second != new_level->second)
+                updates.push_back(LevelUpdate{LevelUpdate::Action::Change, side, new_level->first, new_level->second});
+            ++old_level;
+            ++new_level;
+        }
+    }
+    published.swap(current);
+}
+
+MarketDataHeader MarketDataPublisher::header(bool trade_updated) const
+{
+    return MarketDataHeader{_sequence, trade_updated, _book._transactions_started, _book._last_price,
+                            _book._last_quantity};
+}
@@ -1,125 +1,138 @@
 #include "order_book.h"
 
-#include <iomanip>
-#include <sstream>
-
-uint64_t Order::next_id = 0;
-
-Order::IdType OrderBook::add_order(Order::Type type, Order::PriceType price, Order::QuantityType quantity)
+namespace
 {
-    Order order(type, price, quantity);
-    Order::IdType id = order.id();
-    auto fully_executed = try_execute(order);
-    if (not fully_executed) // place order to book
-    {
-        std::pair<OrderContainerIterator, bool> res;
-        if (type == Order::Type::Bid)
-            res = _bid_queue.emplace(order);
-        else
-            res = _ask_queue.emplace(order);
-        assert(res.second);
-        auto &it = res.first;
-        _id_order_link.emplace(std::make_pair(it->id(), it));
-    }
-    assert(check_consistency());
-    return id;
+// {"price": P, "quantity": Q} object, closing brace is indented as its key
+void output_price_json(JsonWriter &writer, size_t indent, const BookLevel &level)
+{
+    writer.text("{");
+    writer.newline();
+    writer.indent(indent + 4);
+    writer.key("price");
+    writer.number(level.price);
+    writer.text(",");
+    writer.newline();
+    writer.indent(indent + 4);
+    writer.key("quantity");
+    writer.number(level.quantity);
+    writer.newline();
+    writer.indent(indent);
+    writer.text("}");
 }
 
-template <typename Container>
-bool OrderBook::try_execute(Order &order, Container &container, CompareOrderFunction possible_execution)
+template <size_t N>
+void output_named_price_json(JsonWriter &writer, const char (&name)[N], const BookLevel &level)
 {
-    Order container_order = Order::make_zero_order();
+    writer.newline();
+    writer.indent(4);
+    writer.key(name);
+    output_price_json(writer, 4, level);
+}
+} // namespace
 
-    for (auto it = container.begin(); it != container.end() && order.quantity() > 0 && possible_execution(it->price(), order.price());)
-    {
-        // remove first order from book
-        container_order = *it;
-        _id_order_link.erase(it->id());
-        it = container.erase(it);
-        // determine execution parameters
-        auto execution_quantity = std::min(container_order.quantity(), order.quantity());
-        auto execution_price = container_order.price();
-        // execution
-        auto executed_order = container_order.split(execution_quantity, execution_price);
-        send_executed_order(executed_order); //may be full order or part
-        auto executed_incoming_order = order.split(execution_quantity, execution_price);
-        send_executed_order(executed_incoming_order); //may be full order or part
-        // update market data
-        if (_transactions_started && _last_price == execution_price)
-            _last_quantity += execution_quantity;
-        else
-            _last_quantity = execution_quantity;
-        _last_price = execution_price;
-        _transactions_started = true;
-    }
+template class BasicOrderBook<CallbackListener, OrderBookInstrumentation>;
 
-    if (container_order.quantity() != 0) // return rest part of order to OrderBook
-    {
-        auto res = container.emplace(container_order);
-        auto &it = res.first;
-        assert(res.second);
-        _id_order_link.emplace(std::make_pair(it->id(), it));
-    }
-    return order.quantity() == 0;
+void OrderBookBase::set_id_prefix(uint32_t prefix)
+{
+    if (prefix >= (uint64_t(1) << (64 - id_counter_bits)))
+        throw OrderBookBase::Exception("Invalid id prefix");
+    set_id_block(IdSource::prefix_block(prefix));
 }
 
-bool OrderBook::try_execute(Order &order) // return true if incoming order fully executed
+void OrderBookBase::set_id_source(IdSource *source)
 {
-    if (order.type() == Order::Type::Bid)
-    {
-        return try_execute(order, _ask_queue, [](Order::PriceType price_order_in_queue, Order::PriceType price_order_come) {
-            return price_order_in_queue <= price_order_come;
-        });
-    }
-    else
-    {
-        return try_execute(order, _bid_queue, [](Order::PriceType price_order_in_queue, Order::PriceType price_order_come) {
-            return price_order_in_queue >= price_order_come;
-        });
-    }
+    _id_source = source != nullptr ? source : IdSource::shared();
+    _next_id = _end_id = 0;
 }
 
-void OrderBook::cancel_order(Order::IdType id)
+void OrderBookBase::allocate_ids()
 {
-    auto order_link = find_order(id);
-    if (_canceled_order_callback)
-        _canceled_order_callback(*(order_link->second));
-    if (order_link->second->type() == Order::Type::Ask)
-        _ask_queue.erase(order_link->second);
-    else
-        _bid_queue.erase(order_link->second);
-    _id_order_link.erase(order_link);
-    assert(check_consistency());
+    if (_id_source == nullptr)
+        throw OrderBookBase::Exception("Order ids of the book are exhausted");
+    auto last_id = _next_id - 1;
+    auto ids = _id_source->allocate_block();
+    assert(ids.first > last_id || _next_id == 0); // ids of the book are monotonic
+    (void)last_id;
+    _next_id = ids.first;
+    _end_id = ids.end;
 }
 
-Order OrderBook::get_order(Order::IdType id) const
+Order OrderBookBase::get_order(Order::IdType id) const
 {
-    auto order_link = find_order(id);
-    return *(order_link->second);
+    return _orders.order(find_order(id));
 }
 
-std::pair<bool, OrderBook::PricePosition> OrderBook::PriceAggregator::next_price()
+void OrderBookBase::load_orders(Span<const RestingOrder> asks, Span<const RestingOrder> bids,
+                                Span<Order::IdType> ids /*= Span<Order::IdType>()*/)
 {
-    PricePosition price_position;
-    if (_cur_pos == _end_pos) // end of container
-        return std::make_pair(false, price_position);
-    price_position.price = _cur_pos->price();
-    price_position.quantity = _cur_pos->quantity();
-    while ((++_cur_pos != _end_pos) && (_cur_pos->price() == price_position.price))
+    // gives each order next id of the book
+    struct Side
+    {
+        OrderBookBase *book;
+        Order::Type type;
+        Span<const RestingOrder> orders;
+        Order::IdType *ids;
+
+        size_t size() const { return orders.size(); }
+        Order::PriceType price(size_t i) const { return orders[i].price; }
+        Order::QuantityType quantity(size_t i) const { return orders[i].quantity; }
+        Order order(size_t i) const
+        {
+            auto order = book->make_order(type, orders[i].price, orders[i].quantity);
+            if (ids != nullptr)
+                ids[i] = order.id();
+            return order;
+        }
+    };
+
+    auto count = asks.size() + bids.size();
+    if (!ids.empty() && ids.size() < count)
+        throw OrderBookBase::Exception("No room for ids of loaded orders");
+    if (_id_source == nullptr && _end_id - _next_id < count)
+        throw OrderBookBase::Exception("Order ids of the book are exhausted");
+    auto *ask_ids = ids.empty() ? nullptr : ids.data();
+    auto *bid_ids = ids.empty() ? nullptr : ids.data() + asks.size();
+    Side ask_side{this, Order::Type::Ask, asks, ask_ids};
+    Side bid_side{this, Order::Type::Bid, bids, bid_ids};
+    check_bulk_load(ask_side, bid_side);
+    bulk_load(ask_side, bid_side);
+}
+
+size_t OrderBookBase::depth(Order::Type type, Span<BookLevel> levels) const
+{
+    auto aggregator = make_price_aggregator(type);
+    size_t count = 0;
+    for (; count < levels.size(); ++count)
     {
-        price_position.quantity += _cur_pos->quantity();
+        auto price_position_pair = aggregator.next_price();
+        if (!price_position_pair.first)
+            break;
+        levels[count] = price_position_pair.second;
     }
+    return count;
+}
+
+std::pair<bool, BookLevel> OrderBookBase::PriceAggregator::next_price()
+{
+    BookLevel price_position{0, 0, 0};
+    if (!_cursor.valid()) // end of ladder
+        return std::make_pair(false, price_position);
+    const auto &level = _ladder.level(_cursor);
+    price_position.price = level.price;
+    price_position.quantity = level.quantity;
+    price_position.order_count = level.order_count;
+    _ladder.advance(_cursor);
     return std::make_pair(true, price_position);
 }
 
-OrderBook::PriceAggregator OrderBook::make_price_aggregator(Order::Type type) const
+OrderBookBase::PriceAggregator OrderBookBase::make_price_aggregator(Order::Type type) const
 {
     if (type == Order::Type::Ask)
-        return OrderBook::PriceAggregator(_ask_queue.cbegin(), _ask_queue.cend());
+        return OrderBookBase::PriceAggregator(_ask_ladder);
     else
-        return OrderBook::PriceAggregator(_bid_queue.cbegin(), _bid_queue.cend());
+        return OrderBookBase::PriceAggregator(_bid_ladder);
 }
-void out_orders_json(std::ostream &out_str, int order_limit, OrderBook::PriceAggregator &aggregator)
+void out_orders_json(JsonWriter &writer, int order_limit, OrderBookBase::PriceAggregator &aggregator)
 {
     bool next_iteration = false;
 
@@ -130,122 +143,121 @@ void out_orders_json(std::ostream &out_str, int order_limit, OrderBook::PriceAgg
             break; // no more prices in the queue
         if (next_iteration)
         {
-            out_str << "," << std::endl;
+            writer.text(",");
+            writer.newline();
         }
-        out_str << std::setw(8) << " "
-                << "{" << std::endl
-                << std::setw(12) << " "
-                << "\"price\": " << price_position_pair.second.price << "," << std::endl
-                << std::setw(12) << " "
-                << "\"quantity\": " << price_position_pair.second.quantity << std::endl
-                << std::setw(8) << " "
-                << "}";
+        writer.indent(8);
+        output_price_json(writer, 8, price_position_pair.second);
         next_iteration = true;
     }
 }
 
-void OrderBook::orderbook_info_json_internal(std::ostream &out_str,int bid_order_limit, int ask_order_limit) const
+void OrderBookBase::orderbook_info_json_internal(JsonWriter &writer, int bid_order_limit, int ask_order_limit) const
 {
-    out_str << R"V(    "asks": [
-)V";
+    writer.indent(4);
+    writer.key("asks");
+    writer.text("[");
+    writer.newline();
     {
         auto aggregator = make_price_aggregator(Order::Type::Ask);
-        out_orders_json(out_str, ask_order_limit, aggregator);
+        out_orders_json(writer, ask_order_limit, aggregator);
     }
-    out_str << std::endl
-            << std::setw(4) << " "
-            << "]," << std::endl
-            << std::setw(4) << " "
-            << "\"bids\": [" << std::endl;
+    writer.newline();
+    writer.indent(4);
+    writer.text("],");
+    writer.newline();
+    writer.indent(4);
+    writer.key("bids");
+    writer.text("[");
+    writer.newline();
     {
         auto aggregator = make_price_aggregator(Order::Type::Bid);
-        out_orders_json(out_str, bid_order_limit, aggregator);
+        out_orders_json(writer, bid_order_limit, aggregator);
     }
-    out_str << std::endl
-            << std::setw(4) << " "
-            << "]" << std::endl;
+    writer.newline();
+    writer.indent(4);
+    writer.text("]");
+    writer.newline();
 }
 
-std::string OrderBook::orderbook_info_json(int bid_order_limit /*= -1*/, int ask_order_limit /*= -1*/) const
+std::string OrderBookBase::orderbook_info_json(int bid_order_limit /*= -1*/, int ask_order_limit /*= -1*/) const
 {
-    std::ostringstream out_str;
-    out_str << "{" << std::endl;
-    orderbook_info_json_internal(out_str, bid_order_limit, ask_order_limit);
-    out_str << "}" << std::endl;
-    return out_str.str();
+    std::string out;
+    orderbook_info_json(out, bid_order_limit, ask_order_limit);
+    return out;
 }
 
+void OrderBookBase::orderbook_info_json(std::string &out, int bid_order_limit /*= -1*/, int ask_order_limit /*= -1*/,
+                                        JsonFormat format /*= JsonFormat::Pretty*/) const
+{
+    out.clear();
+    JsonWriter writer(out, format);
+    writer.text("{");
+    writer.newline();
+    orderbook_info_json_internal(writer, bid_order_limit, ask_order_limit);
+    writer.text("}");
+    writer.newline();
+}
 
-void output_best_ask_json(std::ostream &out_str,
-                     const std::pair<bool, OrderBook::PricePosition> &ask_price_position_pair)
+bool OrderBookBase::market_data_1_json_internal(JsonWriter &writer) const
 {
+    auto ask_price_position_pair = make_price_aggregator(Order::Type::Ask).next_price();
     if (ask_price_position_pair.first)
+        output_named_price_json(writer, "best_ask", ask_price_position_pair.second);
+    bool next_comma = ask_price_position_pair.first;
+    auto bid_price_position_pair = make_price_aggregator(Order::Type::Bid).next_price();
+    if (next_comma && bid_price_position_pair.first)
+        writer.text(",");
+    if (bid_price_position_pair.first)
+        output_named_price_json(writer, "best_bid", bid_price_position_pair.second);
+    // pretty format keeps missing comma between best bid and last transaction of original output
+    if (!writer.pretty())
+        next_comma = ask_price_position_pair.first || bid_price_position_pair.first;
+    if (_transactions_started)
     {
-        const auto &price_position = ask_price_position_pair.second;
-        out_str << R"V(
-    "best_ask": {
-        "price": )V"
-            << price_position.price << R"V(,
-        "quantity": )V"
-            << price_position.quantity << R"V(
-    })V";
+        if (next_comma)
+            writer.text(",");
+        output_named_price_json(writer, "last_transaction", BookLevel{_last_price, _last_quantity, 0});
+        return true;
     }
+    return ask_price_position_pair.first || bid_price_position_pair.first;
 }
 
-void output_best_bid_json(std::ostream &out_str,
-                     const std::pair<bool, OrderBook::PricePosition> &bid_price_position_pair)
+std::string OrderBookBase::market_data_1_json() const
 {
-    if (bid_price_position_pair.first)
-    {
-        const auto &price_position = bid_price_position_pair.second;
-        out_str << R"V(
-    "best_bid": {
-        "price": )V"
-            << price_position.price << R"V(,
-        "quantity": )V"
-            << price_position.quantity << R"V(
-    })V";
-    }
+    std::string out;
+    market_data_1_json(out);
+    return out;
 }
 
-void OrderBook::market_data_1_json_internal(std::ostream &out_str, bool &next_comma) const
+void OrderBookBase::market_data_1_json(std::string &out, JsonFormat format /*= JsonFormat::Pretty*/) const
 {
-    auto ask_price_position_pair = make_price_aggregator(Order::Type::Ask).next_price();
-    output_best_ask_json(out_str, ask_price_position_pair);
-    next_comma = ask_price_position_pair.first;
-    auto bid_price_position_pair = make_price_aggregator(Order::Type::Bid).next_price();
-    if (next_comma && bid_price_position_pair.first)
-        out_str << ",";
-    output_best_bid_json(out_str, bid_price_position_pair);
-    if (_transactions_started)
-    {
-        if (next_comma) out_str << ",";
-        out_str << R"V(
-    "last_transaction": {
-        "price": )V" << _last_price << R"V(,
-        "quantity": )V" << _last_quantity << R"V(
-    })V";
-    }
+    out.clear();
+    JsonWriter writer(out, format);
+    writer.text("{");
+    market_data_1_json_internal(writer);
+    writer.newline();
+    writer.text("}");
+    writer.newline();
 }
 
-std::string OrderBook::market_data_1_json() const
+std::string OrderBookBase::market_data_2_json(int bid_order_limit /*= -1*/, int ask_order_limit /*= -1*/) const
 {
-    std::ostringstream out_str;
-    out_str << "{";
-    bool next_comma = false;
-    market_data_1_json_internal(out_str, next_comma);
-    out_str << std::endl << "}" << std::endl;
-    return out_str.str();
+    std::string out;
+    market_data_2_json(out, bid_order_limit, ask_order_limit);
+    return out;
 }
 
-std::string OrderBook::market_data_2_json(int bid_order_limit /*= -1*/, int ask_order_limit /*= -1*/) const
+void OrderBookBase::market_data_2_json(std::string &out, int bid_order_limit /*= -1*/, int ask_order_limit /*= -1*/,
+                                       JsonFormat format /*= JsonFormat::Pretty*/) const
 {
-    std::ostringstream out_str;
-    out_str << "{";
-    bool next_comma = false;
-    market_data_1_json_internal(out_str, next_comma);
-    out_str << "," << std::endl;
-    orderbook_info_json_internal(out_str, bid_order_limit, ask_order_limit);
-    out_str << "}" << std::endl;
-    return out_str.str();
+    out.clear();
+    JsonWriter writer(out, format);
+    writer.text("{");
+    if (market_data_1_json_internal(writer) || writer.pretty())
+        writer.text(",");
+    writer.newline();
+    orderbook_info_json_internal(writer, bid_order_limit, ask_order_limit);
+    writer.text("}");
+    writer.newline();
 }
@@ -0,0 +1,159 @@
+#include "order_flow.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include "order_book_base.h"
+
+OrderFlowGenerator::OrderFlowGenerator(const FlowConfig &config /*= FlowConfig()*/)
+    : _config(config), _random(config.seed), _interval(config.arrival_rate)
+{
+    _book.set_id_block(ids());
+}
+
+FlowEvent OrderFlowGenerator::next()
+{
+    _time += _interval(_random) * 1e9;
+    FlowEvent event;
+    event.time = static_cast<uint64_t>(_time);
+    auto kind = _uniform(_random);
+    auto fill = std::min(1.0, static_cast<double>(_live_ids.size()) / static_cast<double>(_config.resting_orders));
+    if (kind < _config.cancel_ratio * fill && !_live_ids.empty())
+    {
+        auto id = _live_ids[std::uniform_int_distribution<size_t>(0, _live_ids.size() - 1)(_random)];
+        event.request = OrderRequest::cancel(id);
+    }
+    else if (kind < _config.cancel_ratio * fill + _config.modify_ratio && !_live_ids.empty())
+    {
+        auto id = _live_ids[std::uniform_int_distribution<size_t>(0, _live_ids.size() - 1)(_random)];
+        auto type = _book.get_order(id).type();
+        auto price = type == Order::Type::Bid ? reference_price(Order::Type::Ask) - offset()
+                                              : reference_price(Order::Type::Bid) + offset();
+        event.request = OrderRequest::modify(id, price, quantity());
+    }
+    else
+    {
+        event.request = add_request();
+    }
+    OrderResult result;
+    _book.add_orders(Span<const OrderRequest>(&event.request, 1), Span<OrderResult>(&result, 1));
+    track(event.request, result);
+    return event;
+}
+
+OrderRequest OrderFlowGenerator::add_request()
+{
+    auto type = _uniform(_random) < 0.5 ? Order::Type::Bid : Order::Type::Ask;
+    auto opposite = type == Order::Type::Bid ? Order::Type::Ask : Order::Type::Bid;
+    auto sign = type == Order::Type::Bid ? 1 : -1; // direction of crossing prices
+    auto touch = reference_price(opposite);
+    auto kind = _uniform(_random);
+    if (kind < _config.sweep_probability)
+    {
+        auto quantity = _config.max_quantity * static_cast<Order::QuantityType>(_config.sweep_levels);
+        return OrderRequest::add(type, touch + sign * _config.sweep_levels, quantity);
+    }
+    if (kind < _config.sweep_probability + _config.aggressive_ratio)
+        return OrderRequest::add(type, touch, quantity());
+    return OrderRequest::add(type, touch - sign * offset(), quantity());
+}
+
+Order::PriceType OrderFlowGenerator::reference_price(Order::Type type) const
+{
+    auto sign = type == Order::Type::Ask ? 1 : -1;
+    auto best = type == Order::Type::Ask ? _book.best_ask() : _book.best_bid();
+    auto other = type == Order::Type::Ask ? _book.best_bid() : _book.best_ask();
+    auto price = best.first ? best.second.price
+                            : (other.first ? other.second.price + sign : _config.mid_price + sign);
+    return std::max(_config.mid_price - _config.mid_drift_limit,
+                    std::min(price, _config.mid_price + _config.mid_drift_limit));
+}
+
+// Pareto distribution with minimum 1 by inverse transform
+Order::PriceType OrderFlowGenerator::offset()
+{
+    auto value = std::pow(1.0 - _uniform(_random), -1.0 / (_config.offset_exponent - 1.0));
+    return static_cast<Order::PriceType>(std::min(value, static_cast<double>(_config.max_offset)));
+}
+
+Order::QuantityType OrderFlowGenerator::quantity()
+{
+    return std::uniform_int_distribution<Order::QuantityType>(_config.min_quantity, _config.max_quantity)(_random);
+}
+
+void OrderFlowGenerator::track(const OrderRequest &request, const OrderResult &result)
+{
+    for (auto id : _book.listener().filled_ids)
+        remove_live(id);
+    _book.listener().filled_ids.clear();
+    if (result.status == OrderResult::Status::Rested && request.action == OrderRequest::Action::Add)
+    {
+        _live_positions[result.id] = _live_ids.size();
+        _live_ids.push_back(result.id);
+    }
+    else if (result.status == OrderResult::Status::Canceled || result.status == OrderResult::Status::Filled)
+    {
+        remove_live(result.id);
+    }
+}
+
+void OrderFlowGenerator::remove_live(Order::IdType id)
+{
+    auto position = _live_positions.find(id);
+    if (position == _live_positions.end())
+        return;
+    _live_ids[position->second] = _live_ids.back();
+    _live_positions[_live_ids.back()] = position->second;
+    _live_ids.pop_back();
+    _live_positions.erase(id);
+}
+
+namespace
+{
+OrderBookBase::Exception flow_error(const std::string &path, size_t line_number, const std::string &line)
+{
+    return OrderBookBase::Exception("Flow " + path + " line " + std::to_string(line_number) + " is invalid: " + line);
+}
+} // namespace
+
+std::vector<FlowEvent> read_flow_csv(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+        throw OrderBookBase::Exception("Flow " + path + " can't be opened");
+    std::vector<FlowEvent> events;
+    std::string line;
+    for (size_t line_number = 1; std::getline(file, line); ++line_number)
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+        std::istringstream fields(line);
+        std::vector<std::string> values;
+        for (std::string value; std::getline(fields, value, ',');)
+            values.push_back(value);
+        FlowEvent event;
+        try
+        {
+            if (values.size() < 3)
+                throw flow_error(path, line_number, line);
+            event.time = std::stoull(values[0]);
+            if (values[1] == "A" && values.size() == 5 && (values[2] == "B" || values[2] == "S"))
+                event.request = OrderRequest::add(values[2] == "B" ? Order::Type::Bid : Order::Type::Ask,
+                                                  std::stoi(values[3]), std::stoul(values[4]));
+            else if (values[1] == "C" && values.size() == 3)
+                event.request = OrderRequest::cancel(std::stoull(values[2]));
+            else if (values[1] == "M" && values.size() == 5)
+                event.request = OrderRequest::modify(std::stoull(values[2]), std::stoi(values[3]), std::stoul(values[4]));
+            else
+                throw flow_error(path, line_number, line);
+        }
+        catch (const std::logic_error &) // invalid or out of range number
+        {
+            throw flow_error(path, line_number, line);
+        }
+        events.push_back(event);
+    }
+    return events;
+}
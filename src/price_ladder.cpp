@@ -0,0 +1,209 @@
+#include "price_ladder.h"
+
+#include <algorithm>
+
+PriceLadder::PriceLadder(Order::Type side, const BookMemory &memory /*= BookMemory()*/)
+    : _side(side), _levels(memory.resource, memory.levels),
+      _sorted_levels(BookAllocator<LevelIndex>(memory.resource)), _non_empty_levels(0, memory.resource),
+      _changed_prices(BookAllocator<Order::PriceType>(memory.resource))
+{
+    _sorted_levels.reserve(memory.levels);
+    _changed_prices.reserve(std::max<size_t>(memory.levels, 64));
+}
+
+PriceLadder::PriceLadder(Order::Type side, const PriceBand &band, const BookMemory &memory /*= BookMemory()*/)
+    : _side(side), _levels(memory.resource, band.size()), _sorted_levels(BookAllocator<LevelIndex>(memory.resource)),
+      _dense(true), _band(band), _non_empty_levels(band.size(), memory.resource),
+      _changed_prices(BookAllocator<Order::PriceType>(memory.resource))
+{
+    _changed_prices.reserve(band.size());
+    for (size_t slot = 0; slot < band.size(); ++slot)
+        _levels.emplace(static_cast<Order::PriceType>(band.min_price + slot * band.tick_size));
+}
+
+std::vector<PriceLadder::LevelIndex, BookAllocator<PriceLadder::LevelIndex>>::const_iterator
+PriceLadder::find_position(Order::PriceType price) const
+{
+    return std::lower_bound(_sorted_levels.begin(), _sorted_levels.end(), price,
+                            [this](LevelIndex index, Order::PriceType price) {
+                                return worse(_levels[index].price, price);
+                            });
+}
+
+const PriceLevel *PriceLadder::find(Order::PriceType price) const
+{
+    if (_dense)
+    {
+        if (!_band.contains(price))
+            return nullptr;
+        const auto &level = _levels[static_cast<LevelIndex>(_band.slot(price))];
+        return level.head == OrderPool::null_index ? nullptr : &level;
+    }
+    auto pos = find_position(price);
+    if (pos != _sorted_levels.end() && _levels[*pos].price == price)
+        return &_levels[*pos];
+    return nullptr;
+}
+
+void PriceLadder::clear_changes()
+{
+    if (_dense) // empty levels stay in place and keep their flags
+    {
+        if (_changes_overflow)
+        {
+            for (LevelIndex i = 0; i < _levels.size(); ++i)
+                _levels[i].changed = false;
+        }
+        else
+        {
+            for (auto price : _changed_prices)
+                _levels[static_cast<LevelIndex>(_band.slot(price))].changed = false;
+        }
+    }
+    else if (_changes_overflow) // removed levels are released, flags are reset on the remaining ones
+    {
+        for (auto level_index : _sorted_levels)
+            _levels[level_index].changed = false;
+    }
+    else
+    {
+        for (auto price : _changed_prices)
+        {
+            auto pos = find_position(price);
+            if (pos != _sorted_levels.end() && _levels[*pos].price == price)
+                _levels[*pos].changed = false;
+        }
+    }
+    _changed_prices.clear();
+    _changes_overflow = false;
+}
+
+PriceLadder::LevelIndex PriceLadder::dense_level(Order::PriceType price)
+{
+    auto level_index = static_cast<LevelIndex>(_band.slot(price));
+    if (_levels[level_index].head == OrderPool::null_index)
+    {
+        _non_empty_levels.set(level_index);
+        ++_dense_level_count;
+    }
+    return level_index;
+}
+
+void PriceLadder::link_back(OrderPool &orders, OrderNode::Index node_index, LevelIndex level_index)
+{
+    auto &node = orders[node_index];
+    auto &cold = orders.cold(node_index);
+    auto &level = _levels[level_index];
+    cold.level = level_index;
+    cold.prev = level.tail;
+    node.next = OrderPool::null_index;
+    if (level.tail != OrderPool::null_index)
+        orders[level.tail].next = node_index;
+    else
+        level.head = node_index;
+    level.tail = node_index;
+    level.quantity += node.quantity;
+    ++level.order_count;
+    mark_changed(level);
+}
+
+void PriceLadder::push_back(OrderPool &orders, OrderNode::Index node_index)
+{
+    const auto price = orders.cold(node_index).price;
+    LevelIndex level_index;
+    if (_dense)
+    {
+        level_index = dense_level(price);
+    }
+    else if (!_sorted_levels.empty() && _levels[_sorted_levels.back()].price == price)
+    {
+        level_index = _sorted_levels.back(); // most orders are placed at the best price
+    }
+    else
+    {
+        auto pos = find_position(price);
+        if (pos != _sorted_levels.end() && _levels[*pos].price == price)
+        {
+            level_index = *pos;
+        }
+        else
+        {
+            level_index = _levels.emplace(price);
+            _sorted_levels.insert(pos, level_index);
+        }
+    }
+    link_back(orders, node_index, level_index);
+}
+
+// while loading sparse ladder levels are appended from the best to the worst and reversed by finish_load
+void PriceLadder::load_back(OrderPool &orders, OrderNode::Index node_index)
+{
+    const auto price = orders.cold(node_index).price;
+    LevelIndex level_index;
+    if (_dense)
+    {
+        level_index = dense_level(price);
+    }
+    else if (!_sorted_levels.empty() && _levels[_sorted_levels.back()].price == price)
+    {
+        level_index = _sorted_levels.back();
+    }
+    else
+    {
+        assert(_sorted_levels.empty() || worse(price, _levels[_sorted_levels.back()].price));
+        level_index = _levels.emplace(price);
+        _sorted_levels.push_back(level_index);
+    }
+    link_back(orders, node_index, level_index);
+}
+
+void PriceLadder::finish_load()
+{
+    std::reverse(_sorted_levels.begin(), _sorted_levels.end());
+}
+
+void PriceLadder::unlink(OrderPool &orders, OrderNode::Index node_index, LevelIndex level_index)
+{
+    const auto &node = orders[node_index];
+    auto &level = _levels[level_index];
+    if (level.head == node_index) // executed orders are unlinked here without reading their cold records
+    {
+        level.head = node.next;
+        if (level.tail == node_index)
+            level.tail = OrderPool::null_index;
+    }
+    else
+    {
+        auto prev = orders.cold(node_index).prev;
+        orders[prev].next = node.next;
+        if (level.tail == node_index)
+            level.tail = prev;
+        else
+            orders.cold(node.next).prev = prev;
+    }
+    level.quantity -= node.quantity;
+    --level.order_count;
+    mark_changed(level);
+    if (level.head == OrderPool::null_index) // level is empty
+    {
+        if (_dense)
+        {
+            _non_empty_levels.reset(level_index);
+            --_dense_level_count;
+        }
+        else
+        {
+            if (_sorted_levels.back() == level_index)
+            {
+                _sorted_levels.pop_back();
+            }
+            else
+            {
+                auto pos = find_position(level.price);
+                assert(pos != _sorted_levels.end() && *pos == level_index);
+                _sorted_levels.erase(pos);
+            }
+            _levels.release(level_index);
+        }
+    }
+}
@@ -0,0 +1,23 @@
+#include "thread_affinity.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+bool pin_thread_to_core(std::thread &thread, size_t core)
+{
+#ifdef __linux__
+    auto core_count = std::thread::hardware_concurrency();
+    if (core_count == 0)
+        return false;
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(core % core_count, &cpu_set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+    (void)thread;
+    (void)core;
+    return false;
+#endif
+}
@@ -0,0 +1,140 @@
+#include "allocation_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <stdlib.h>
+
+// All forms of global new and delete are replaced, so every block is counted and comes from malloc
+// and goes back to free: sanitizers report mismatch if one form is left to the runtime.
+
+static std::atomic<size_t> allocations{0};
+
+size_t allocation_count()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+static void *counted_malloc(size_t size) noexcept
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void *operator new(size_t size)
+{
+    if (void *ptr = counted_malloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    if (void *ptr = counted_malloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return counted_malloc(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return counted_malloc(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+#ifdef __cpp_aligned_new
+// aligned_alloc wants size multiple of alignment, its blocks are released by free as well
+static void *counted_aligned_alloc(size_t size, std::align_val_t alignment) noexcept
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    auto align = static_cast<size_t>(alignment);
+    return ::aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    if (void *ptr = counted_aligned_alloc(size, alignment))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+    if (void *ptr = counted_aligned_alloc(size, alignment))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return counted_aligned_alloc(size, alignment);
+}
+
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return counted_aligned_alloc(size, alignment);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+#endif
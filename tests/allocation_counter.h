@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstddef>
+
+/// @brief number of global operator new calls made by the process
+size_t allocation_count();
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include "binary_market_data.h"
+#include "test_book.h"
+
+TEST(BINARY_MARKET_DATA, Depth)
+{
+    auto order_book = test_order_book();
+    std::vector<uint8_t> buffer(order_book.depth_binary_size());
+    ASSERT_EQ(order_book.depth_binary(42, buffer), buffer.size());
+
+    auto header = binary_market_data::read_header(buffer.data());
+    EXPECT_EQ(header.sequence, 42u);
+    ASSERT_EQ(header.ask_count, order_book.level_count(Order::Type::Ask));
+    ASSERT_EQ(header.bid_count, order_book.level_count(Order::Type::Bid));
+    EXPECT_EQ(buffer.size(), binary_market_data::header_size +
+                                 binary_market_data::level_size * (header.ask_count + header.bid_count));
+    EXPECT_EQ(header.flags != 0, order_book.market_data_1_json().find("last_transaction") != std::string::npos);
+
+    std::array<BookLevel, 64> levels;
+    auto ask_count = order_book.depth(Order::Type::Ask, levels);
+    for (size_t i = 0; i < ask_count; ++i)
+    {
+        auto level = binary_market_data::read_level(buffer.data(), i);
+        EXPECT_EQ(level.price, levels[i].price);
+        EXPECT_EQ(level.quantity, levels[i].quantity);
+        EXPECT_EQ(level.order_count, levels[i].order_count);
+    }
+    auto bid_count = order_book.depth(Order::Type::Bid, levels);
+    for (size_t i = 0; i < bid_count; ++i)
+    {
+        auto level = binary_market_data::read_level(buffer.data(), ask_count + i);
+        EXPECT_EQ(level.price, levels[i].price);
+        EXPECT_EQ(level.quantity, levels[i].quantity);
+    }
+}
+
+TEST(BINARY_MARKET_DATA, Limits)
+{
+    OrderBook order_book;
+    order_book.add_order(Order::Type::Ask, -5, 3);
+    order_book.add_order(Order::Type::Ask, 7, 1);
+    order_book.add_order(Order::Type::Bid, -10, 2);
+
+    std::array<uint8_t, 64> buffer;
+    ASSERT_EQ(order_book.depth_binary_size(0, 1), binary_market_data::header_size + binary_market_data::level_size);
+    EXPECT_EQ(order_book.depth_binary(1, Span<uint8_t>(buffer.data(), 40), 0, 1), 0u); // buffer is too small
+    ASSERT_EQ(order_book.depth_binary(1, buffer, 0, 1), 44u);
+    const std::array<uint8_t, 44> expected = {
+        1, 0, 0, 0, 0, 0, 0, 0,          // sequence
+        1, 0, 0, 0, 0, 0, 0, 0,          // ask and bid counts
+        0, 0, 0, 0, 0, 0, 0, 0,          // no trades
+        0, 0, 0, 0, 0, 0, 0, 0,          // flags and reserved
+        0xfb, 0xff, 0xff, 0xff, 3, 0, 0, 0, 1, 0, 0, 0 // ask -5
+    };
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), buffer.begin()));
+}
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <type_traits>
+#include "basic_order_book.hpp"
+
+static_assert(std::is_empty<NoInstrumentation>::value, "book without instrumentation keeps no state for it");
+
+TEST(BOOK_INSTRUMENTATION, Counters)
+{
+    BookMemory memory;
+    memory.orders = 2; // the third resting order grows storage
+    BasicOrderBook<NullListener, BookInstrumentation> order_book(NullListener(), memory);
+    order_book.add_order(Order::Type::Ask, 101, 5);
+    order_book.add_order(Order::Type::Ask, 101, 5);
+    auto partially_filled_id = order_book.add_order(Order::Type::Ask, 102, 5);
+    auto modified_id = order_book.add_order(Order::Type::Ask, 103, 5);
+    order_book.add_order(Order::Type::Bid, 102, 12); // fills both orders of 101 and part of 102
+    order_book.cancel_order(partially_filled_id);
+    order_book.modify_order(modified_id, 103, 3);
+
+    auto stats = order_book.stats();
+    EXPECT_EQ(stats.adds, 5u);
+    EXPECT_EQ(stats.cancels, 1u);
+    EXPECT_EQ(stats.modifies, 1u);
+    EXPECT_EQ(stats.fills, 2u);
+    EXPECT_EQ(stats.partial_fills, 1u);
+    EXPECT_EQ(stats.aggressive_orders, 1u);
+    EXPECT_GT(stats.storage_growths, 0u);
+    EXPECT_EQ(stats.levels_swept.count, 1u);
+    EXPECT_EQ(stats.levels_swept.max, 2u);
+    EXPECT_EQ(stats.queue_depth.count, 4u);
+    EXPECT_EQ(stats.queue_depth.max, 2u);
+    EXPECT_EQ(stats.add_cycles.count, 5u);
+    EXPECT_EQ(stats.execute_cycles.count, 5u);
+    EXPECT_EQ(stats.cancel_cycles.count, 1u);
+    EXPECT_LE(stats.add_cycles.p50, stats.add_cycles.max);
+}
+
+TEST(BOOK_INSTRUMENTATION, Disabled)
+{
+    BasicOrderBook<NullListener> order_book;
+    order_book.add_order(Order::Type::Ask, 101, 5);
+    order_book.add_order(Order::Type::Bid, 101, 5);
+    auto stats = order_book.stats();
+    EXPECT_EQ(stats.adds, 0u);
+    EXPECT_EQ(stats.add_cycles.count, 0u);
+}
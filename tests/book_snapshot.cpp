@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "book_snapshot.h"
+#include "journal.h"
+
+namespace
+{
+struct MakerListener : NullListener
+{
+    void on_trade(const TradeEvent &trade) { makers.push_back(trade.maker_id); }
+    std::vector<Order::IdType> makers;
+};
+
+using Book = BasicOrderBook<MakerListener>;
+
+std::string snapshot_path(const char *name)
+{
+    return testing::TempDir() + name;
+}
+
+// random adds, cancels and modifies with prices inside [990, 1010)
+void random_flow(Book &order_book, int count, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<Order::IdType> ids;
+    for (int i = 0; i < count; ++i)
+    {
+        auto kind = random() % 4;
+        OrderRequest request;
+        if (kind == 0 && !ids.empty())
+            request = OrderRequest::cancel(ids[random() % ids.size()]);
+        else if (kind == 1 && !ids.empty())
+            request = OrderRequest::modify(ids[random() % ids.size()], 990 + random() % 20, random() % 10);
+        else
+            request = OrderRequest::add(random() % 2 ? Order::Type::Ask : Order::Type::Bid, 990 + random() % 20,
+                                        1 + random() % 10);
+        OrderResult result;
+        order_book.add_orders(Span<const OrderRequest>(&request, 1), Span<OrderResult>(&result, 1));
+        ids.push_back(result.id);
+    }
+}
+
+// books have the same levels, last trade and next id, and execute the same orders in the same order
+void expect_same_books(Book &book, Book &restored_book)
+{
+    EXPECT_EQ(restored_book.market_data_2_json(), book.market_data_2_json());
+    EXPECT_EQ(restored_book.orderbook_info_json(), book.orderbook_info_json());
+    book.listener().makers.clear();
+    restored_book.listener().makers.clear();
+    EXPECT_EQ(restored_book.add_order(Order::Type::Bid, 1009, 100000), book.add_order(Order::Type::Bid, 1009, 100000));
+    EXPECT_EQ(restored_book.add_order(Order::Type::Ask, 990, 200000), book.add_order(Order::Type::Ask, 990, 200000));
+    EXPECT_FALSE(book.listener().makers.empty());
+    EXPECT_EQ(restored_book.listener().makers, book.listener().makers);
+}
+} // namespace
+
+TEST(BOOK_SNAPSHOT, SaveLoad)
+{
+    auto path = snapshot_path("save_load.snapshot");
+    Book order_book;
+    order_book.set_id_prefix(5);
+    random_flow(order_book, 3000, 21);
+    order_book.save_snapshot(path);
+
+    Book restored_book;
+    restored_book.load_snapshot(path);
+    EXPECT_EQ(restored_book.id_block().first, order_book.id_block().first);
+    expect_same_books(order_book, restored_book);
+    unlink(path.c_str());
+}
+
+TEST(BOOK_SNAPSHOT, SaveLoadPriceBand)
+{
+    auto path = snapshot_path("save_load_band.snapshot");
+    Book order_book(PriceBand{980, 1020, 1});
+    order_book.set_id_prefix(6);
+    random_flow(order_book, 3000, 22);
+    order_book.save_snapshot(path);
+
+    Book restored_book(PriceBand{980, 1020, 1});
+    restored_book.load_snapshot(path);
+    expect_same_books(order_book, restored_book);
+
+    Book narrow_book(PriceBand{1000, 1020, 1});
+    EXPECT_THROW(narrow_book.load_snapshot(path), OrderBookBase::Exception);
+    EXPECT_EQ(narrow_book.level_count(Order::Type::Bid), 0u);
+    unlink(path.c_str());
+}
+
+TEST(BOOK_SNAPSHOT, SnapshotAndJournalTail)
+{
+    auto snapshot = snapshot_path("recovery.snapshot");
+    auto journal_path = snapshot_path("recovery.journal");
+    Book order_book;
+    order_book.set_id_prefix(7);
+    random_flow(order_book, 2000, 23);
+    order_book.save_snapshot(snapshot);
+    {
+        JournalWriter journal(journal_path, order_book);
+        std::vector<OrderRequest> requests;
+        for (int i = 0; i < 100; ++i)
+            requests.push_back(OrderRequest::add(i % 2 ? Order::Type::Ask : Order::Type::Bid, 995 + i % 10, 3));
+        std::vector<OrderResult> results(requests.size());
+        add_orders_journaled(order_book, journal, requests, results);
+    }
+
+    Book restored_book;
+    restored_book.load_snapshot(snapshot);
+    EXPECT_EQ(replay_journal(journal_path, restored_book), 100u);
+    expect_same_books(order_book, restored_book);
+    unlink(snapshot.c_str());
+    unlink(journal_path.c_str());
+}
+
+TEST(BOOK_SNAPSHOT, Errors)
+{
+    auto path = snapshot_path("errors.snapshot");
+    Book order_book;
+    order_book.add_order(Order::Type::Ask, 100, 1);
+    order_book.save_snapshot(path);
+    EXPECT_THROW(order_book.load_snapshot(path), OrderBookBase::Exception); // book isn't empty
+
+    ASSERT_EQ(truncate(path.c_str(), book_snapshot::header_size + book_snapshot::record_size - 1), 0);
+    Book truncated_book;
+    EXPECT_THROW(truncated_book.load_snapshot(path), OrderBookBase::Exception);
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "not a snapshot";
+    }
+    EXPECT_THROW(truncated_book.load_snapshot(path), OrderBookBase::Exception);
+    EXPECT_THROW(truncated_book.load_snapshot(snapshot_path("missing.snapshot")), OrderBookBase::Exception);
+    unlink(path.c_str());
+}
+
+// Restored book taking ids from fresh source, as after restart of the process, never gives ids of loaded orders
+TEST(BOOK_SNAPSHOT, SharedIdSource)
+{
+    auto path = snapshot_path("shared_ids.snapshot");
+    Book order_book; // takes ids from shared source
+    std::vector<Order::IdType> ids;
+    for (int i = 0; i < 10; ++i)
+        ids.push_back(order_book.add_order(Order::Type::Ask, 1000 + i, 1));
+    order_book.save_snapshot(path);
+
+    BlockIdSource restarted_source(4);
+    Book restored_book;
+    restored_book.set_id_source(&restarted_source);
+    restored_book.load_snapshot(path);
+    auto bid_id = restored_book.add_order(Order::Type::Bid, 900, 1);
+    EXPECT_GT(bid_id, *std::max_element(ids.begin(), ids.end()));
+    restored_book.cancel_order(bid_id);
+    EXPECT_EQ(restored_book.level_count(Order::Type::Bid), 0u);
+    EXPECT_EQ(restored_book.level_count(Order::Type::Ask), 10u);
+    for (auto id : ids)
+        EXPECT_EQ(restored_book.get_order(id).id(), id);
+
+    ThreadIdSource thread_source; // can't skip ids
+    Book thread_book;
+    thread_book.set_id_source(&thread_source);
+    EXPECT_THROW(thread_book.load_snapshot(path), OrderBookBase::Exception);
+    EXPECT_EQ(thread_book.level_count(Order::Type::Ask), 0u);
+
+    // rejected snapshot leaves shared source as it was
+    BlockIdSource untouched_source(4);
+    Book banded_book(PriceBand{900, 1005, 1});
+    banded_book.set_id_source(&untouched_source);
+    EXPECT_THROW(banded_book.load_snapshot(path), OrderBookBase::OutOfBandException);
+    EXPECT_EQ(untouched_source.allocate_block().first, 1u);
+    unlink(path.c_str());
+}
+
+TEST(BOOK_SNAPSHOT, DuplicateIdLeavesBookEmpty)
+{
+    auto path = snapshot_path("duplicate.snapshot");
+    Book order_book;
+    order_book.set_id_prefix(8);
+    order_book.add_order(Order::Type::Ask, 1000, 1);
+    order_book.add_order(Order::Type::Ask, 1001, 1);
+    order_book.save_snapshot(path);
+    std::vector<char> data;
+    {
+        std::ifstream file(path, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    auto valid_data = data;
+    std::copy_n(data.begin() + book_snapshot::header_size, 8,
+                data.begin() + book_snapshot::header_size + book_snapshot::record_size);
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+    Book restored_book;
+    EXPECT_THROW(restored_book.load_snapshot(path), OrderBookBase::Exception);
+    EXPECT_EQ(restored_book.level_count(Order::Type::Ask), 0u);
+
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(valid_data.data(), static_cast<std::streamsize>(valid_data.size()));
+    }
+    restored_book.load_snapshot(path); // nothing of failed load was left in the book
+    EXPECT_EQ(restored_book.level_count(Order::Type::Ask), 2u);
+    unlink(path.c_str());
+}
+
+// failed save doesn't touch the previous snapshot
+TEST(BOOK_SNAPSHOT, FailedSaveKeepsSnapshot)
+{
+    auto path = snapshot_path("failed_save.snapshot");
+    Book order_book;
+    order_book.set_id_prefix(9);
+    order_book.add_order(Order::Type::Ask, 1000, 1);
+    order_book.save_snapshot(path);
+    order_book.add_order(Order::Type::Ask, 1001, 1);
+    auto temp_path = path + ".tmp";
+    ASSERT_EQ(mkdir(temp_path.c_str(), 0755), 0); // temporary file can't be created
+    EXPECT_THROW(order_book.save_snapshot(path), OrderBookBase::Exception);
+    rmdir(temp_path.c_str());
+
+    Book restored_book;
+    restored_book.load_snapshot(path);
+    EXPECT_EQ(restored_book.level_count(Order::Type::Ask), 1u);
+    unlink(path.c_str());
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "basic_order_book.hpp"
+#include "depth_query.h"
+
+namespace
+{
+const DepthQuery::SimdLevel simd_levels[] = {DepthQuery::SimdLevel::Scalar, DepthQuery::SimdLevel::Sse42,
+                                             DepthQuery::SimdLevel::Avx2};
+} // namespace
+
+TEST(DEPTH_QUERY, Queries)
+{
+    BasicOrderBook<NullListener> order_book;
+    order_book.add_order(Order::Type::Ask, 1001, 5);
+    order_book.add_order(Order::Type::Ask, 1001, 5);
+    order_book.add_order(Order::Type::Ask, 1003, 20);
+    order_book.add_order(Order::Type::Ask, 1010, 30);
+    order_book.add_order(Order::Type::Bid, 999, 7);
+    order_book.add_order(Order::Type::Bid, 990, 3);
+
+    for (auto level : simd_levels)
+    {
+        DepthQuery query(3, level);
+        query.update(order_book);
+        EXPECT_LE(query.simd_level(), DepthQuery::supported_simd_level());
+        EXPECT_EQ(query.level_count(Order::Type::Ask), 3u);
+        EXPECT_EQ(query.quantity_within(Order::Type::Ask, -1), 0u);
+        EXPECT_EQ(query.quantity_within(Order::Type::Ask, 0), 10u);
+        EXPECT_EQ(query.quantity_within(Order::Type::Ask, 2), 30u);
+        EXPECT_EQ(query.quantity_within(Order::Type::Ask, 1000), 60u);
+        EXPECT_EQ(query.quantity_within(Order::Type::Bid, 8), 7u);
+        EXPECT_EQ(query.quantity_within(Order::Type::Bid, 9), 10u);
+
+        auto estimate = query.fill(Order::Type::Ask, 15);
+        EXPECT_TRUE(estimate.complete);
+        EXPECT_EQ(estimate.quantity, 15u);
+        EXPECT_EQ(estimate.worst_price, 1003);
+        EXPECT_EQ(estimate.levels, 2u);
+        EXPECT_EQ(estimate.notional, 10 * 1001 + 5 * 1003);
+        EXPECT_DOUBLE_EQ(estimate.vwap(), (10 * 1001 + 5 * 1003) / 15.0);
+
+        estimate = query.fill(Order::Type::Ask, 10); // exactly the best level
+        EXPECT_EQ(estimate.worst_price, 1001);
+        EXPECT_EQ(estimate.levels, 1u);
+
+        estimate = query.fill(Order::Type::Bid, 100); // not enough quantity
+        EXPECT_FALSE(estimate.complete);
+        EXPECT_EQ(estimate.quantity, 10u);
+        EXPECT_EQ(estimate.worst_price, 990);
+        EXPECT_EQ(estimate.levels, 2u);
+
+        BasicOrderBook<NullListener> empty_book;
+        query.update(empty_book);
+        EXPECT_EQ(query.quantity_within(Order::Type::Ask, 10), 0u);
+        EXPECT_FALSE(query.fill(Order::Type::Bid, 1).complete);
+        EXPECT_EQ(query.fill(Order::Type::Bid, 1).levels, 0u);
+    }
+}
+
+// router thread refreshes its DepthQuery from snapshot published by the book thread
+TEST(DEPTH_QUERY, UpdateFromSnapshot)
+{
+    BasicOrderBook<NullListener> order_book;
+    for (int i = 0; i < 20; ++i)
+    {
+        order_book.add_order(Order::Type::Ask, 1001 + i, 10 + i);
+        order_book.add_order(Order::Type::Bid, 999 - i, 5 + i);
+    }
+    DepthSnapshot<8> snapshot;
+    snapshot.publish(order_book);
+    DepthSnapshotData<8> data;
+    snapshot.read(data);
+
+    DepthQuery from_book(8);
+    from_book.update(order_book);
+    DepthQuery from_snapshot(8);
+    from_snapshot.update(data);
+    for (auto type : {Order::Type::Ask, Order::Type::Bid})
+    {
+        EXPECT_EQ(from_snapshot.level_count(type), 8u);
+        for (int distance = 0; distance < 10; ++distance)
+            EXPECT_EQ(from_snapshot.quantity_within(type, distance), from_book.quantity_within(type, distance));
+        for (uint64_t quantity = 1; quantity < 200; quantity += 13)
+        {
+            EXPECT_EQ(from_snapshot.fill(type, quantity).notional, from_book.fill(type, quantity).notional);
+            EXPECT_EQ(from_snapshot.fill(type, quantity).complete, from_book.fill(type, quantity).complete);
+        }
+    }
+}
+
+// deep book checks linear scan and binary search against walk over depth()
+TEST(DEPTH_QUERY, MatchesDepthWalk)
+{
+    std::mt19937 random(7);
+    BasicOrderBook<NullListener> order_book;
+    for (int i = 0; i < 3000; ++i)
+        order_book.add_order(Order::Type::Bid, 10000 - static_cast<int>(random() % 400), 1 + random() % 50);
+    std::vector<BookLevel> levels(300);
+    levels.resize(order_book.depth(Order::Type::Bid, levels));
+
+    for (auto level : simd_levels)
+    {
+        DepthQuery query(300, level);
+        query.update(order_book);
+        ASSERT_EQ(query.level_count(Order::Type::Bid), levels.size());
+        for (int distance = 0; distance < 420; distance += 7)
+        {
+            uint64_t expected = 0;
+            for (const auto &book_level : levels)
+            {
+                if (levels[0].price - book_level.price <= distance)
+                    expected += book_level.quantity;
+            }
+            EXPECT_EQ(query.quantity_within(Order::Type::Bid, distance), expected) << distance;
+        }
+        for (uint64_t quantity = 1; quantity < 90000; quantity = quantity * 3 / 2 + 1)
+        {
+            FillEstimate expected;
+            for (const auto &book_level : levels)
+            {
+                if (expected.quantity == quantity)
+                    break;
+                auto taken = std::min<uint64_t>(book_level.quantity, quantity - expected.quantity);
+                expected.quantity += taken;
+                expected.notional += static_cast<int64_t>(taken) * book_level.price;
+                expected.worst_price = book_level.price;
+                ++expected.levels;
+            }
+            auto estimate = query.fill(Order::Type::Bid, quantity);
+            EXPECT_EQ(estimate.quantity, expected.quantity) << quantity;
+            EXPECT_EQ(estimate.notional, expected.notional) << quantity;
+            EXPECT_EQ(estimate.worst_price, expected.worst_price) << quantity;
+            EXPECT_EQ(estimate.levels, expected.levels) << quantity;
+            EXPECT_EQ(estimate.complete, expected.quantity == quantity) << quantity;
+        }
+    }
+}
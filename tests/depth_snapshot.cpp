@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "depth_snapshot.hpp"
+#include "order_pipeline.hpp"
+
+TEST(DEPTH_SNAPSHOT, Publish)
+{
+    BasicOrderBook<NullListener> order_book;
+    DepthSnapshot<2> snapshot;
+    DepthSnapshot<2>::Data data;
+    snapshot.read(data);
+    EXPECT_EQ(data.version, 0u);
+    EXPECT_EQ(data.ask_count, 0u);
+
+    order_book.add_order(Order::Type::Ask, 1003, 1);
+    order_book.add_order(Order::Type::Ask, 1002, 2);
+    order_book.add_order(Order::Type::Ask, 1001, 3);
+    order_book.add_order(Order::Type::Bid, 1001, 1);
+    snapshot.publish(order_book);
+    snapshot.read(data);
+    EXPECT_EQ(data.version, 1u);
+    ASSERT_EQ(data.ask_count, 2u);
+    EXPECT_EQ(data.asks[0].price, 1001);
+    EXPECT_EQ(data.asks[0].quantity, 2u);
+    EXPECT_EQ(data.asks[1].price, 1002);
+    EXPECT_EQ(data.bid_count, 0u);
+    EXPECT_TRUE(data.has_last_trade);
+    EXPECT_EQ(data.last_trade.price, 1001);
+    EXPECT_EQ(data.last_trade.quantity, 1u);
+}
+
+// every order has quantity equal to its price, so torn read breaks quantity of the level
+TEST(DEPTH_SNAPSHOT, ConcurrentReaders)
+{
+    BasicOrderBook<NullListener> order_book;
+    OrderPipeline<> pipeline(order_book, 64, 64, 4);
+    DepthSnapshot<8> snapshot;
+    pipeline.set_observer(&snapshot);
+    pipeline.start();
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i)
+    {
+        readers.emplace_back([&snapshot, &done] {
+            uint64_t version = 0;
+            DepthSnapshot<8>::Data data;
+            while (!done.load())
+            {
+                snapshot.read(data);
+                ASSERT_GE(data.version, version);
+                version = data.version;
+                ASSERT_LE(data.ask_count, 8u);
+                for (uint32_t level = 0; level < data.ask_count; ++level)
+                {
+                    const auto &ask = data.asks[level];
+                    ASSERT_EQ(ask.quantity, static_cast<Order::QuantityType>(ask.price) * ask.order_count);
+                    if (level > 0)
+                    {
+                        ASSERT_GT(data.asks[level].price, data.asks[level - 1].price);
+                    }
+                }
+                std::this_thread::yield();
+            }
+        });
+    }
+    // cancels of odd ids wait here while ingress ring is full, results are polled meanwhile so that
+    // matching thread never waits for outbound ring
+    std::vector<Order::IdType> cancels;
+    auto pump = [&pipeline, &cancels] {
+        PipelineResult results[64];
+        auto count = pipeline.poll(results);
+        for (size_t result = 0; result < count; ++result)
+        {
+            if (results[result].result.status == OrderResult::Status::Rested && results[result].result.id % 2)
+                cancels.push_back(results[result].result.id);
+        }
+        while (!cancels.empty() && pipeline.submit(OrderRequest::cancel(cancels.back())))
+            cancels.pop_back();
+        std::this_thread::yield();
+    };
+    const int order_count = 5000;
+    for (int i = 0; i < order_count; ++i)
+    {
+        Order::PriceType price = 1 + (i * 7) % 50;
+        while (!pipeline.submit(OrderRequest::add(Order::Type::Ask, price, price)))
+            pump();
+        pump();
+    }
+    while (!cancels.empty())
+        pump();
+    done = true;
+    for (auto &reader : readers)
+        reader.join();
+
+    // stop waits for matching thread, which may wait for room in outbound ring
+    std::atomic<bool> stopped{false};
+    std::thread stopper([&pipeline, &stopped] {
+        pipeline.stop();
+        stopped = true;
+    });
+    PipelineResult results[64];
+    while (!stopped.load())
+    {
+        pipeline.poll(results);
+        std::this_thread::yield();
+    }
+    stopper.join();
+}
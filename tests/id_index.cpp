@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "id_index.hpp"
+
+TEST(ID_INDEX, InsertFindErase)
+{
+    IdIndex index;
+    std::vector<Order::IdType> ids;
+    for (Order::IdType id = 1; id <= 10000; ++id)
+        ids.push_back(id * (id % 3 == 0 ? 64 : 1)); // some ids collide by home slot
+    for (size_t i = 0; i < ids.size(); ++i)
+        ASSERT_TRUE(index.insert(ids[i], static_cast<IdIndex::Value>(i)));
+    ASSERT_FALSE(index.insert(ids[0], 0));
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(1));
+    auto half = ids.size() / 2;
+    for (size_t i = 0; i < half; ++i)
+        ASSERT_TRUE(index.erase(ids[i]));
+    ASSERT_EQ(index.size(), ids.size() - half);
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        ASSERT_EQ(index.find(ids[i]) == nullptr, i < half);
+        ASSERT_EQ(index.erase(ids[i]), i >= half);
+    }
+    ASSERT_EQ(index.size(), 0);
+}
+
+// Ids of prefixed books are consecutive in low bits, orders are canceled in the order they were added.
+// Identity hash made live ids one run of occupied slots walked by each erase, so this took seconds.
+TEST(ID_INDEX, SlidingWindowOfPrefixedIds)
+{
+    IdIndex index;
+    const Order::IdType prefix = Order::IdType(5) << 40;
+    const Order::IdType window = 100000;
+    for (Order::IdType id = 1; id <= 4 * window; ++id)
+    {
+        ASSERT_TRUE(index.insert(prefix | id, static_cast<IdIndex::Value>(id)));
+        if (id > window)
+        {
+            ASSERT_TRUE(index.erase(prefix | (id - window)));
+        }
+    }
+    ASSERT_EQ(index.size(), window);
+    ASSERT_EQ(index.find(prefix | window * 3), nullptr);
+    ASSERT_NE(index.find(prefix | (window * 3 + 1)), nullptr);
+    EXPECT_EQ(*index.find(prefix | (window * 4)), window * 4);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <set>
+#include <thread>
+#include <vector>
+#include "basic_order_book.hpp"
+
+namespace
+{
+// books on several threads add orders, ids have to be unique and increasing in each book
+void check_unique_ids(IdSource &source)
+{
+    const size_t thread_count = 4;
+    std::vector<std::vector<Order::IdType>> ids(thread_count * 2);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back([&source, &ids, i] {
+            BasicOrderBook<NullListener> first_book, second_book;
+            first_book.set_id_source(&source);
+            second_book.set_id_source(&source);
+            for (int n = 0; n < 1000; ++n)
+            {
+                ids[i * 2].push_back(first_book.add_order(Order::Type::Bid, 100, 1));
+                ids[i * 2 + 1].push_back(second_book.add_order(Order::Type::Ask, 200, 1));
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    std::set<Order::IdType> all_ids;
+    for (const auto &book_ids : ids)
+    {
+        EXPECT_TRUE(std::is_sorted(book_ids.begin(), book_ids.end()));
+        all_ids.insert(book_ids.begin(), book_ids.end());
+    }
+    EXPECT_EQ(all_ids.size(), thread_count * 2 * 1000);
+    EXPECT_EQ(all_ids.count(0), 0u);
+}
+} // namespace
+
+TEST(ID_SOURCE, ThreadIdSource)
+{
+    ThreadIdSource source(64);
+    check_unique_ids(source);
+}
+
+TEST(ID_SOURCE, BlockIdSource)
+{
+    BlockIdSource source(16);
+    check_unique_ids(source);
+}
+
+TEST(ID_SOURCE, Prefix)
+{
+    BasicOrderBook<NullListener> order_book;
+    EXPECT_THROW(order_book.set_id_prefix(1u << 24), OrderBookBase::Exception);
+    order_book.set_id_prefix(5);
+    EXPECT_EQ(order_book.add_order(Order::Type::Bid, 100, 1), (Order::IdType(5) << IdSource::counter_bits) + 1);
+    EXPECT_EQ(order_book.add_order(Order::Type::Bid, 100, 1), (Order::IdType(5) << IdSource::counter_bits) + 2);
+}
+
+// shared source stops at the end of prefix 0 instead of handing out ids of prefixed books
+TEST(ID_SOURCE, BlockIdSourceLimit)
+{
+    const auto end = IdSource::prefix_block(0).end;
+    BlockIdSource source(16, end - 40);
+    EXPECT_FALSE(source.reserve_through(end));
+    EXPECT_TRUE(source.reserve_through(end - 21));
+    BasicOrderBook<NullListener> order_book;
+    order_book.set_id_source(&source);
+    for (Order::IdType id = end - 20; id < end; ++id)
+        EXPECT_EQ(order_book.add_order(Order::Type::Bid, 100, 1), id);
+    EXPECT_THROW(order_book.add_order(Order::Type::Bid, 100, 1), OrderBookBase::Exception);
+    EXPECT_THROW(source.allocate_block(), OrderBookBase::Exception);
+    EXPECT_TRUE(source.reserve_through(end - 1));
+
+    BlockIdSource huge_blocks(~size_t(0), end - 5); // block end doesn't wrap around
+    auto block = huge_blocks.allocate_block();
+    EXPECT_EQ(block.first, end - 5);
+    EXPECT_EQ(block.end, end);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <unistd.h>
+#include <vector>
+#include "journal.h"
+
+namespace
+{
+struct MakerListener : NullListener
+{
+    void on_trade(const TradeEvent &trade) { makers.push_back(trade.maker_id); }
+    std::vector<Order::IdType> makers;
+};
+
+using Book = BasicOrderBook<MakerListener>;
+
+std::string journal_path(const char *name)
+{
+    return testing::TempDir() + name;
+}
+
+// random adds, cancels and modifies processed by the book and journaled in batches
+void journal_random_flow(Book &order_book, JournalWriter &journal, int batch_count)
+{
+    std::mt19937 random(11);
+    std::vector<Order::IdType> ids;
+    for (int batch = 0; batch < batch_count; ++batch)
+    {
+        std::vector<OrderRequest> requests;
+        for (int i = 0; i < 10; ++i)
+        {
+            auto kind = random() % 4;
+            if (kind == 0 && !ids.empty())
+                requests.push_back(OrderRequest::cancel(ids[random() % ids.size()]));
+            else if (kind == 1 && !ids.empty())
+                requests.push_back(OrderRequest::modify(ids[random() % ids.size()], 990 + random() % 20, random() % 10));
+            else
+                requests.push_back(OrderRequest::add(random() % 2 ? Order::Type::Ask : Order::Type::Bid,
+                                                     990 + random() % 20, 1 + random() % 10));
+        }
+        std::vector<OrderResult> results(requests.size());
+        add_orders_journaled(order_book, journal, requests, results);
+        for (const auto &result : results)
+            ids.push_back(result.id);
+    }
+}
+} // namespace
+
+TEST(JOURNAL, ReplaySameBook)
+{
+    auto path = journal_path("replay_same_book.journal");
+    Book order_book;
+    order_book.set_id_prefix(3);
+    {
+        JournalWriter journal(path, order_book, 16, 256);
+        journal_random_flow(order_book, journal, 500);
+        EXPECT_EQ(journal.sequence(), 5000u);
+    }
+    Book replayed_book;
+    EXPECT_EQ(replay_journal(path, replayed_book), 5000u);
+    EXPECT_EQ(replayed_book.market_data_2_json(), order_book.market_data_2_json());
+
+    // the same ids are executed in the same order
+    order_book.listener().makers.clear();
+    replayed_book.listener().makers.clear();
+    EXPECT_EQ(replayed_book.add_order(Order::Type::Bid, 2000, 100000), order_book.add_order(Order::Type::Bid, 2000, 100000));
+    EXPECT_EQ(replayed_book.add_order(Order::Type::Ask, 1, 100000), order_book.add_order(Order::Type::Ask, 1, 100000));
+    EXPECT_FALSE(order_book.listener().makers.empty());
+    EXPECT_EQ(replayed_book.listener().makers, order_book.listener().makers);
+    unlink(path.c_str());
+}
+
+TEST(JOURNAL, IncompleteRecord)
+{
+    auto path = journal_path("incomplete_record.journal");
+    Book order_book;
+    order_book.set_id_prefix(4);
+    {
+        JournalWriter journal(path, order_book, 0);
+        journal_random_flow(order_book, journal, 1);
+    }
+    ASSERT_EQ(truncate(path.c_str(), journal::header_size + journal::record_size * 10 - 5), 0);
+    Book replayed_book;
+    EXPECT_EQ(replay_journal(path, replayed_book), 9u);
+    unlink(path.c_str());
+}
+
+TEST(JOURNAL, Errors)
+{
+    Book order_book; // takes ids from shared source
+    EXPECT_THROW(JournalWriter(journal_path("errors.journal"), order_book), OrderBookBase::Exception);
+    EXPECT_THROW(JournalReader(journal_path("missing.journal")), OrderBookBase::Exception);
+
+    order_book.set_id_prefix(1);
+    try
+    {
+        JournalWriter journal("/dev/full", order_book, 1, journal::record_size); // header write fails
+        journal.append(OrderRequest::add(Order::Type::Bid, 1000, 1));
+        FAIL() << "write to full device succeeded";
+    }
+    catch (const OrderBookBase::Exception &e)
+    {
+        EXPECT_NE(std::string(e.what()).find("/dev/full"), std::string::npos) << e.what();
+    }
+}
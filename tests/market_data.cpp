@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+#include "basic_order_book.hpp"
+#include "market_data.h"
+
+namespace
+{
+using Levels = std::map<std::pair<Order::Type, Order::PriceType>, Order::QuantityType>;
+
+void apply(Levels &levels, const std::vector<LevelUpdate> &updates)
+{
+    for (const auto &update : updates)
+    {
+        auto key = std::make_pair(update.side, update.price);
+        if (update.action == LevelUpdate::Action::New)
+        {
+            EXPECT_EQ(levels.count(key), 0u);
+            levels[key] = update.quantity;
+        }
+        else if (update.action == LevelUpdate::Action::Change)
+        {
+            ASSERT_EQ(levels.count(key), 1u);
+            EXPECT_NE(levels[key], update.quantity);
+            levels[key] = update.quantity;
+        }
+        else
+        {
+            EXPECT_EQ(levels.erase(key), 1u);
+        }
+    }
+}
+
+// random flow published after each few operations, consumer state is compared with new publisher
+void check_random_flow(BasicOrderBook<NullListener> &order_book)
+{
+    MarketDataPublisher publisher(order_book);
+    std::mt19937 random(7);
+    std::vector<Order::IdType> ids;
+    std::vector<LevelUpdate> updates;
+    Levels levels;
+    uint64_t sequence = 0;
+    for (int i = 0; i < 5000; ++i)
+    {
+        if (!ids.empty() && random() % 3 == 0)
+        {
+            auto pos = random() % ids.size();
+            try
+            {
+                order_book.cancel_order(ids[pos]);
+            }
+            catch (const OrderBookBase::NotFoundException &)
+            {
+            }
+            ids[pos] = ids.back();
+            ids.pop_back();
+        }
+        else
+        {
+            auto type = random() % 2 ? Order::Type::Ask : Order::Type::Bid;
+            ids.push_back(order_book.add_order(type, 980 + random() % 40, 1 + random() % 20));
+        }
+        if (i % 7 == 0)
+        {
+            updates.clear();
+            auto header = publisher.publish(updates);
+            EXPECT_EQ(header.sequence, updates.empty() && !header.trade_updated ? sequence : sequence + 1);
+            sequence = header.sequence;
+            apply(levels, updates);
+        }
+    }
+    updates.clear();
+    publisher.publish(updates);
+    apply(levels, updates);
+
+    Levels expected;
+    updates.clear();
+    MarketDataPublisher(order_book).publish(updates);
+    apply(expected, updates);
+    EXPECT_EQ(levels, expected);
+}
+} // namespace
+
+TEST(MARKET_DATA, Updates)
+{
+    BasicOrderBook<NullListener> order_book;
+    order_book.add_order(Order::Type::Ask, 1001, 10);
+    MarketDataPublisher publisher(order_book);
+    std::vector<LevelUpdate> updates;
+
+    auto header = publisher.publish(updates); // levels placed before publisher are published as new
+    EXPECT_EQ(header.sequence, 1u);
+    EXPECT_FALSE(header.has_last_trade);
+    ASSERT_EQ(updates.size(), 1u);
+    EXPECT_EQ(updates[0].action, LevelUpdate::Action::New);
+    EXPECT_EQ(updates[0].quantity, 10u);
+
+    updates.clear();
+    auto bid_id = order_book.add_order(Order::Type::Bid, 999, 5);
+    order_book.add_order(Order::Type::Ask, 1001, 7);
+    order_book.cancel_order(bid_id); // level added and removed between publishes isn't reported
+    order_book.add_order(Order::Type::Bid, 1001, 3);
+    header = publisher.publish(updates);
+    EXPECT_EQ(header.sequence, 2u);
+    EXPECT_TRUE(header.trade_updated);
+    EXPECT_TRUE(header.has_last_trade);
+    EXPECT_EQ(header.last_price, 1001);
+    EXPECT_EQ(header.last_quantity, 3u);
+    ASSERT_EQ(updates.size(), 1u);
+    EXPECT_EQ(updates[0].action, LevelUpdate::Action::Change);
+    EXPECT_EQ(updates[0].side, Order::Type::Ask);
+    EXPECT_EQ(updates[0].price, 1001);
+    EXPECT_EQ(updates[0].quantity, 14u);
+
+    updates.clear();
+    header = publisher.publish(updates); // nothing changed
+    EXPECT_EQ(header.sequence, 2u);
+    EXPECT_FALSE(header.trade_updated);
+    EXPECT_TRUE(updates.empty());
+
+    order_book.add_order(Order::Type::Bid, 1001, 14);
+    header = publisher.publish(updates);
+    ASSERT_EQ(updates.size(), 1u);
+    EXPECT_EQ(updates[0].action, LevelUpdate::Action::Delete);
+    EXPECT_EQ(updates[0].quantity, 0u);
+
+    updates.clear();
+    order_book.add_order(Order::Type::Bid, 998, 1);
+    order_book.add_order(Order::Type::Ask, 1003, 2);
+    order_book.add_order(Order::Type::Bid, 999, 4);
+    header = publisher.snapshot(updates); // snapshot doesn't include changes not published yet
+    EXPECT_EQ(header.sequence, 3u);
+    EXPECT_TRUE(updates.empty());
+    publisher.publish(updates);
+    updates.clear();
+    header = publisher.snapshot(updates);
+    EXPECT_EQ(header.sequence, 4u);
+    ASSERT_EQ(updates.size(), 3u);
+    EXPECT_EQ(updates[0].price, 1003);
+    EXPECT_EQ(updates[1].price, 999);
+    EXPECT_EQ(updates[2].price, 998);
+}
+
+TEST(MARKET_DATA, RandomFlow)
+{
+    BasicOrderBook<NullListener> order_book;
+    check_random_flow(order_book);
+}
+
+TEST(MARKET_DATA, RandomFlowBand)
+{
+    BasicOrderBook<NullListener> order_book(PriceBand{900, 1100, 1});
+    check_random_flow(order_book);
+}
+
+TEST(MARKET_DATA, ChangesOverflow)
+{
+    BasicOrderBook<NullListener> order_book;
+    MarketDataPublisher publisher(order_book);
+    std::vector<LevelUpdate> updates;
+    publisher.publish(updates);
+    for (Order::PriceType price = 0; price < 1000; ++price)
+        order_book.add_order(Order::Type::Ask, 2000 + price, 1);
+    publisher.publish(updates);
+    EXPECT_EQ(updates.size(), 1000u);
+    Levels levels;
+    apply(levels, updates);
+    EXPECT_EQ(levels.size(), 1000u);
+}
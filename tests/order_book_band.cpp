@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <limits>
+#include "hierarchical_bitset.hpp"
+#include "order_book.h"
+#include "test_book.h"
+
+TEST(ORDER_BOOK_BAND, BitsetSearch)
+{
+    const size_t npos = HierarchicalBitset::npos;
+    HierarchicalBitset bitset(100000);
+    ASSERT_TRUE(bitset.empty());
+    ASSERT_EQ(bitset.find_first(), npos);
+    const std::array<size_t, 5> positions = {3, 63, 64, 4097, 99999};
+    for (auto pos : positions)
+        bitset.set(pos);
+    ASSERT_EQ(bitset.find_first(), 3);
+    ASSERT_EQ(bitset.find_last(), 99999);
+    for (size_t i = 0; i + 1 < positions.size(); ++i)
+    {
+        ASSERT_EQ(bitset.find_next(positions[i]), positions[i + 1]);
+        ASSERT_EQ(bitset.find_prev(positions[i + 1]), positions[i]);
+    }
+    ASSERT_EQ(bitset.find_next(99999), npos);
+    ASSERT_EQ(bitset.find_prev(3), npos);
+    bitset.reset(64);
+    ASSERT_EQ(bitset.find_next(63), 4097);
+    for (auto pos : positions)
+        bitset.reset(pos);
+    ASSERT_TRUE(bitset.empty());
+}
+
+TEST(ORDER_BOOK_BAND, SameAsSparseBook)
+{
+    const PriceBand band{700, 1100, 1};
+    const std::array<Data, 4> incoming = {
+        Data{Order::Type::Bid, 1002, 45},
+        Data{Order::Type::Ask, 900, 80},
+        Data{Order::Type::Bid, 1000, 300},
+        Data{Order::Type::Ask, 800, 400},
+    };
+    OrderBook sparse_book = test_order_book();
+    OrderBook dense_book = test_order_book(band);
+    ASSERT_EQ(sparse_book.market_data_2_json(), dense_book.market_data_2_json());
+    for (const auto &order : incoming)
+    {
+        sparse_book.add_order(order.type, order.price, order.quantity);
+        dense_book.add_order(order.type, order.price, order.quantity);
+        ASSERT_EQ(sparse_book.market_data_2_json(), dense_book.market_data_2_json());
+    }
+}
+
+TEST(ORDER_BOOK_BAND, OutOfBandRejected)
+{
+    OrderBook order_book(PriceBand{900, 1100, 5});
+    ASSERT_THROW(order_book.add_order(Order::Type::Bid, 895, 10), OrderBook::OutOfBandException);
+    ASSERT_THROW(order_book.add_order(Order::Type::Ask, 1105, 10), OrderBook::OutOfBandException);
+    ASSERT_THROW(order_book.add_order(Order::Type::Ask, 1001, 10), OrderBook::OutOfBandException);
+    auto id = order_book.add_order(Order::Type::Ask, 1100, 10);
+    ASSERT_EQ(order_book.get_order(id).price(), 1100);
+    ASSERT_THROW(OrderBook(PriceBand{1100, 900, 1}), OrderBook::Exception);
+    // price difference of the widest band doesn't fit PriceType
+    const auto min_price = std::numeric_limits<Order::PriceType>::min();
+    const auto max_price = std::numeric_limits<Order::PriceType>::max();
+    ASSERT_THROW(OrderBook(PriceBand{min_price, max_price, 1}), OrderBook::Exception);
+    ASSERT_THROW(OrderBook(PriceBand{0, static_cast<Order::PriceType>(PriceBand::max_slots), 1}), OrderBook::Exception);
+    const Order::PriceType tick_size = 1 << 14;
+    OrderBook wide_tick_book(PriceBand{min_price, max_price, tick_size});
+    const auto top_price = max_price - (tick_size - 1);
+    ASSERT_EQ(wide_tick_book.get_order(wide_tick_book.add_order(Order::Type::Bid, top_price, 10)).price(), top_price);
+    ASSERT_THROW(wide_tick_book.add_order(Order::Type::Bid, max_price, 10), OrderBook::OutOfBandException);
+}
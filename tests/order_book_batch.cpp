@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+#include "order_book.h"
+#include "test_book.h"
+
+TEST(ORDER_BOOK_BATCH, SameAsSingleCalls)
+{
+    OrderBook order_book = test_order_book();
+    OrderBook batch_book;
+    std::vector<OrderRequest> requests = {
+        OrderRequest::add(Order::Type::Ask, 1003, 50),
+        OrderRequest::add(Order::Type::Ask, 1003, 40),
+        OrderRequest::add(Order::Type::Ask, 1002, 30),
+        OrderRequest::add(Order::Type::Ask, 1001, 20),
+        OrderRequest::add(Order::Type::Ask, 1001, 10),
+        OrderRequest::add(Order::Type::Bid, 999, 15),
+        OrderRequest::add(Order::Type::Bid, 999, 25),
+        OrderRequest::add(Order::Type::Bid, 900, 35),
+        OrderRequest::add(Order::Type::Bid, 900, 44),
+        OrderRequest::add(Order::Type::Bid, 800, 55),
+    };
+    std::vector<OrderResult> results(requests.size());
+    ASSERT_EQ(batch_book.add_orders(requests, results), requests.size());
+    ASSERT_EQ(batch_book.market_data_2_json(), order_book.market_data_2_json());
+    for (const auto &result : results)
+    {
+        ASSERT_EQ(result.status, OrderResult::Status::Rested);
+        ASSERT_NO_THROW(batch_book.get_order(result.id));
+    }
+}
+
+TEST(ORDER_BOOK_BATCH, Results)
+{
+    std::array<TradeEvent, 8> trades;
+    BasicOrderBook<TradeEventWriter> order_book(PriceBand{900, 1100, 1}, TradeEventWriter(trades.data(), trades.size()));
+    auto ask_id = order_book.add_order(Order::Type::Ask, 1001, 20);
+    auto bid_id = order_book.add_order(Order::Type::Bid, 999, 20);
+    const std::array<OrderRequest, 6> requests = {
+        OrderRequest::add(Order::Type::Bid, 1001, 5),
+        OrderRequest::cancel(bid_id),
+        OrderRequest::cancel(bid_id),
+        OrderRequest::add(Order::Type::Ask, 1200, 5),
+        OrderRequest::modify(ask_id, 1000, 30),
+        OrderRequest::add(Order::Type::Bid, 1000, 40),
+    };
+    std::array<OrderResult, 6> results;
+    ASSERT_EQ(order_book.add_orders(requests, results), 6);
+
+    ASSERT_EQ(results[0].status, OrderResult::Status::Filled);
+    ASSERT_EQ(results[0].executed_quantity, 5);
+    ASSERT_EQ(results[0].trade_count, 1);
+    ASSERT_EQ(results[1].status, OrderResult::Status::Canceled);
+    ASSERT_EQ(results[1].id, bid_id);
+    ASSERT_EQ(results[2].status, OrderResult::Status::NotFound);
+    ASSERT_EQ(results[3].status, OrderResult::Status::Rejected);
+    ASSERT_EQ(results[4].status, OrderResult::Status::Rested);
+    ASSERT_EQ(results[4].id, ask_id);
+    ASSERT_THROW(order_book.get_order(ask_id), OrderBook::NotFoundException);
+    ASSERT_EQ(results[5].status, OrderResult::Status::Rested);
+    ASSERT_EQ(results[5].executed_quantity, 30);
+    ASSERT_EQ(results[5].trade_count, 1);
+    ASSERT_EQ(order_book.get_order(results[5].id).quantity(), 10);
+
+    const auto &writer = order_book.listener();
+    ASSERT_EQ(writer.size(), 2); // events of the whole batch
+    ASSERT_EQ(writer.events()[1].maker_id, results[4].id);
+    ASSERT_EQ(writer.events()[1].taker_id, results[5].id);
+}
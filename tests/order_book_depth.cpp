@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <array>
+#include "order_book.h"
+
+namespace
+{
+void check_levels(OrderBook &order_book)
+{
+    EXPECT_FALSE(order_book.best_bid().first);
+    EXPECT_FALSE(order_book.best_ask().first);
+
+    auto ask_id = order_book.add_order(Order::Type::Ask, 1003, 10);
+    order_book.add_order(Order::Type::Ask, 1003, 5);
+    order_book.add_order(Order::Type::Ask, 1005, 7);
+    auto bid_id = order_book.add_order(Order::Type::Bid, 1000, 4);
+    order_book.add_order(Order::Type::Bid, 999, 6);
+
+    auto ask = order_book.best_ask();
+    ASSERT_TRUE(ask.first);
+    EXPECT_EQ(ask.second.price, 1003);
+    EXPECT_EQ(ask.second.quantity, 15u);
+    EXPECT_EQ(ask.second.order_count, 2u);
+
+    order_book.add_order(Order::Type::Bid, 1003, 3); // partial fill keeps order in the level
+    ask = order_book.best_ask();
+    EXPECT_EQ(ask.second.quantity, 12u);
+    EXPECT_EQ(ask.second.order_count, 2u);
+
+    order_book.cancel_order(ask_id);
+    ask = order_book.best_ask();
+    EXPECT_EQ(ask.second.quantity, 5u);
+    EXPECT_EQ(ask.second.order_count, 1u);
+
+    order_book.modify_order(bid_id, 1000, 1);
+    auto bid = order_book.best_bid();
+    ASSERT_TRUE(bid.first);
+    EXPECT_EQ(bid.second.price, 1000);
+    EXPECT_EQ(bid.second.quantity, 1u);
+    EXPECT_EQ(bid.second.order_count, 1u);
+
+    std::array<BookLevel, 3> levels;
+    ASSERT_EQ(order_book.level_count(Order::Type::Ask), 2u);
+    ASSERT_EQ(order_book.depth(Order::Type::Ask, levels), 2u);
+    EXPECT_EQ(levels[0].price, 1003);
+    EXPECT_EQ(levels[1].price, 1005);
+    EXPECT_EQ(levels[1].quantity, 7u);
+    ASSERT_EQ(order_book.depth(Order::Type::Bid, Span<BookLevel>(levels.data(), 1)), 1u);
+    EXPECT_EQ(levels[0].price, 1000);
+
+    order_book.add_order(Order::Type::Ask, 990, 8); // sweeps bids
+    EXPECT_FALSE(order_book.best_bid().first);
+    EXPECT_EQ(order_book.depth(Order::Type::Bid, levels), 0u);
+    EXPECT_EQ(order_book.best_ask().second.price, 990);
+}
+} // namespace
+
+TEST(ORDER_BOOK_DEPTH, Levels)
+{
+    OrderBook order_book;
+    check_levels(order_book);
+}
+
+TEST(ORDER_BOOK_DEPTH, LevelsBand)
+{
+    OrderBook order_book(PriceBand{900, 1100, 1});
+    check_levels(order_book);
+}
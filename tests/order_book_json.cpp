@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "allocation_counter.h"
+#include "order_book.h"
+#include "test_book.h"
+
+TEST(ORDER_BOOK_JSON, Compact)
+{
+    OrderBook order_book;
+    std::string out;
+    order_book.market_data_2_json(out, -1, -1, JsonFormat::Compact);
+    EXPECT_EQ(out, R"V({"asks":[],"bids":[]})V");
+
+    order_book.add_order(Order::Type::Bid, -20, 5);
+    order_book.add_order(Order::Type::Ask, -20, 2);
+    order_book.market_data_1_json(out, JsonFormat::Compact);
+    EXPECT_EQ(out, R"V({"best_bid":{"price":-20,"quantity":3},"last_transaction":{"price":-20,"quantity":2}})V");
+
+    order_book.add_order(Order::Type::Ask, 1234567890, 4000000000u);
+    order_book.market_data_2_json(out, -1, 0, JsonFormat::Compact);
+    EXPECT_EQ(out, R"V({"best_ask":{"price":1234567890,"quantity":4000000000},)V"
+                   R"V("best_bid":{"price":-20,"quantity":3},"last_transaction":{"price":-20,"quantity":2},)V"
+                   R"V("asks":[],"bids":[{"price":-20,"quantity":3}]})V");
+}
+
+TEST(ORDER_BOOK_JSON, SameAsStringResult)
+{
+    OrderBook order_book = test_order_book();
+    std::string out;
+    order_book.orderbook_info_json(out, 2, 1);
+    EXPECT_EQ(out, order_book.orderbook_info_json(2, 1));
+    order_book.market_data_1_json(out);
+    EXPECT_EQ(out, order_book.market_data_1_json());
+    order_book.market_data_2_json(out);
+    EXPECT_EQ(out, order_book.market_data_2_json());
+
+    auto allocations = allocation_count(); // reused string doesn't grow
+    order_book.market_data_2_json(out);
+    order_book.market_data_2_json(out, -1, -1, JsonFormat::Compact);
+    EXPECT_EQ(allocation_count(), allocations);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+#include "basic_order_book.hpp"
+
+namespace
+{
+struct Event
+{
+    char kind;
+    Order::IdType id;
+    Order::PriceType price;
+    Order::QuantityType quantity;
+};
+
+struct RecordingListener : NullListener
+{
+    void on_add(const Order &order) { record('A', order); }
+    void on_execute(const Order &order) { record('E', order); }
+    void on_cancel(const Order &order) { record('C', order); }
+    void record(char kind, const Order &order)
+    {
+        events.push_back(Event{kind, order.id(), order.price(), order.quantity()});
+    }
+    std::vector<Event> events;
+};
+} // namespace
+
+TEST(ORDER_BOOK_LISTENER, Events)
+{
+    BasicOrderBook<RecordingListener> order_book;
+    auto ask_id = order_book.add_order(Order::Type::Ask, 1001, 20);
+    auto bid_id = order_book.add_order(Order::Type::Bid, 1002, 30);
+    order_book.cancel_order(bid_id);
+    const std::vector<Event> results = {
+        Event{'A', ask_id, 1001, 20},
+        Event{'E', ask_id, 1001, 20},
+        Event{'E', bid_id, 1001, 20},
+        Event{'A', bid_id, 1002, 10},
+        Event{'C', bid_id, 1002, 10},
+    };
+    const auto &events = order_book.listener().events;
+    ASSERT_EQ(events.size(), results.size());
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        ASSERT_EQ(events[i].kind, results[i].kind);
+        ASSERT_EQ(events[i].id, results[i].id);
+        ASSERT_EQ(events[i].price, results[i].price);
+        ASSERT_EQ(events[i].quantity, results[i].quantity);
+    }
+}
+
+TEST(ORDER_BOOK_LISTENER, NullListener)
+{
+    BasicOrderBook<NullListener> order_book(PriceBand{900, 1100, 1});
+    order_book.add_order(Order::Type::Ask, 1001, 20);
+    order_book.add_order(Order::Type::Bid, 1001, 5);
+    ASSERT_EQ(order_book.market_data_1_json(), R"V({
+    "best_ask": {
+        "price": 1001,
+        "quantity": 15
+    },
+    "last_transaction": {
+        "price": 1001,
+        "quantity": 5
+    }
+}
+)V");
+}
+
+TEST(ORDER_BOOK_LISTENER, TradeEvents)
+{
+    std::array<TradeEvent, 2> buffer;
+    BasicOrderBook<TradeEventWriter> order_book(TradeEventWriter(buffer.data(), buffer.size()));
+    auto ask_id1 = order_book.add_order(Order::Type::Ask, 1001, 20);
+    auto ask_id2 = order_book.add_order(Order::Type::Ask, 1002, 30);
+    auto bid_id = order_book.add_order(Order::Type::Bid, 1002, 40);
+    const auto &writer = order_book.listener();
+    ASSERT_EQ(writer.size(), 2);
+    ASSERT_EQ(writer.dropped(), 0);
+    const auto &first = writer.events()[0];
+    ASSERT_EQ(first.sequence, 1);
+    ASSERT_EQ(first.maker_id, ask_id1);
+    ASSERT_EQ(first.taker_id, bid_id);
+    ASSERT_EQ(first.price, 1001);
+    ASSERT_EQ(first.quantity, 20);
+    ASSERT_EQ(first.maker_remaining, 0);
+    ASSERT_EQ(first.taker_remaining, 20);
+    ASSERT_EQ(first.aggressor, Order::Type::Bid);
+    const auto &second = writer.events()[1];
+    ASSERT_EQ(second.sequence, 2);
+    ASSERT_EQ(second.maker_id, ask_id2);
+    ASSERT_EQ(second.price, 1002);
+    ASSERT_EQ(second.quantity, 20);
+    ASSERT_EQ(second.maker_remaining, 10);
+    ASSERT_EQ(second.taker_remaining, 0);
+
+    order_book.listener().reset();
+    order_book.add_order(Order::Type::Bid, 1002, 5);
+    order_book.add_order(Order::Type::Bid, 1002, 2);
+    order_book.add_order(Order::Type::Bid, 1002, 1);
+    ASSERT_EQ(writer.size(), 2);
+    ASSERT_EQ(writer.dropped(), 1);
+    ASSERT_EQ(writer.events()[1].sequence, 4);
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "test_book.h"
+
+namespace
+{
+std::vector<RestingOrder> test_asks()
+{
+    return {{1001, 20}, {1001, 10}, {1002, 30}, {1003, 50}, {1003, 40}};
+}
+
+std::vector<RestingOrder> test_bids()
+{
+    return {{999, 15}, {999, 25}, {900, 35}, {900, 44}, {800, 55}};
+}
+
+void expect_same_levels(const OrderBook &order_book, const OrderBook &loaded_book)
+{
+    EXPECT_EQ(loaded_book.market_data_2_json(), order_book.market_data_2_json());
+    EXPECT_EQ(loaded_book.market_data_1_json(), order_book.market_data_1_json());
+}
+} // namespace
+
+TEST(ORDER_BOOK_LOAD, SameAsAddOrder)
+{
+    OrderBook loaded_book;
+    std::vector<Order::IdType> ids(10);
+    loaded_book.load_orders(test_asks(), test_bids(), ids);
+    expect_same_levels(test_order_book(), loaded_book);
+
+    // orders keep given queue order
+    EXPECT_EQ(loaded_book.get_order(ids[0]).quantity(), 20u);
+    EXPECT_EQ(loaded_book.get_order(ids[9]).price(), 800);
+    std::vector<Order> executed;
+    loaded_book.listener() = CallbackListener([&](Order order) { executed.push_back(order); }, nullptr);
+    loaded_book.add_order(Order::Type::Bid, 1001, 25);
+    ASSERT_EQ(executed.size(), 4u);
+    EXPECT_EQ(executed[0].id(), ids[0]);
+    EXPECT_EQ(executed[2].id(), ids[1]);
+    EXPECT_EQ(executed[2].quantity(), 5u);
+}
+
+TEST(ORDER_BOOK_LOAD, PriceBand)
+{
+    PriceBand band{800, 1010, 1};
+    OrderBook loaded_book(band);
+    loaded_book.load_orders(test_asks(), test_bids());
+    expect_same_levels(test_order_book(band), loaded_book);
+    loaded_book.cancel_order(loaded_book.add_order(Order::Type::Ask, 1000, 1));
+    expect_same_levels(test_order_book(band), loaded_book);
+
+    OrderBook narrow_book(PriceBand{900, 1010, 1});
+    EXPECT_THROW(narrow_book.load_orders(test_asks(), test_bids()), OrderBookBase::OutOfBandException);
+    EXPECT_EQ(narrow_book.level_count(Order::Type::Ask), 0u);
+}
+
+TEST(ORDER_BOOK_LOAD, Errors)
+{
+    OrderBook order_book;
+    std::vector<RestingOrder> unsorted_asks = {{1002, 1}, {1001, 1}};
+    std::vector<RestingOrder> crossing_bids = {{1001, 1}};
+    std::vector<RestingOrder> empty_order = {{1001, 0}};
+    EXPECT_THROW(order_book.load_orders(unsorted_asks, {}), OrderBookBase::Exception);
+    EXPECT_THROW(order_book.load_orders(test_asks(), crossing_bids), OrderBookBase::Exception);
+    EXPECT_THROW(order_book.load_orders(empty_order, {}), OrderBookBase::Exception);
+    std::vector<Order::IdType> ids(3);
+    EXPECT_THROW(order_book.load_orders(test_asks(), {}, ids), OrderBookBase::Exception);
+    order_book.set_id_block(IdBlock{1, 4});
+    EXPECT_THROW(order_book.load_orders(test_asks(), {}), OrderBookBase::Exception);
+    EXPECT_EQ(order_book.level_count(Order::Type::Ask), 0u);
+
+    order_book.set_id_block(IdBlock{1, 100});
+    order_book.load_orders(test_asks(), test_bids());
+    EXPECT_THROW(order_book.load_orders(test_asks(), {}), OrderBookBase::Exception); // book isn't empty
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <mutex>
+#include <random>
+#include <set>
+#include <vector>
+#include "allocation_counter.h"
+#include "order_book_manager.hpp"
+
+TEST(ORDER_BOOK_MANAGER, SameAsSingleBooks)
+{
+    const size_t instrument_count = 50;
+    std::mutex results_mutex;
+    std::vector<std::vector<OrderResult>> results(instrument_count);
+    OrderBookManager<> manager(4, [&](uint32_t instrument, const OrderResult &result) {
+        std::lock_guard<std::mutex> lock(results_mutex);
+        results[instrument].push_back(result);
+    });
+    std::vector<BasicOrderBook<NullListener>> reference_books(instrument_count);
+    for (uint32_t instrument = 0; instrument < instrument_count; ++instrument)
+    {
+        if (instrument % 2)
+            manager.add_book(instrument);
+        else
+            manager.add_book(instrument, PriceBand{900, 1100, 1});
+    }
+    EXPECT_EQ(manager.book_count(), instrument_count);
+    EXPECT_EQ(manager.book(1000), nullptr);
+    EXPECT_THROW(manager.add_book(0), OrderBookBase::Exception);
+
+    manager.start();
+    EXPECT_THROW(manager.add_book(1000), OrderBookBase::Exception);
+    EXPECT_FALSE(manager.submit(1000, OrderRequest::add(Order::Type::Ask, 1000, 1)));
+    std::mt19937 random(3);
+    std::vector<std::vector<OrderRequest>> requests(instrument_count);
+    for (int i = 0; i < 20000; ++i)
+    {
+        uint32_t instrument = random() % instrument_count;
+        auto type = random() % 2 ? Order::Type::Ask : Order::Type::Bid;
+        auto request = OrderRequest::add(type, 990 + random() % 20, 1 + random() % 10);
+        ASSERT_TRUE(manager.submit(instrument, request));
+        requests[instrument].push_back(request);
+    }
+    manager.wait_idle();
+    manager.stop();
+
+    std::set<Order::IdType> ids;
+    for (uint32_t instrument = 0; instrument < instrument_count; ++instrument)
+    {
+        auto &reference_book = reference_books[instrument];
+        std::vector<OrderResult> reference_results(requests[instrument].size());
+        reference_book.add_orders(requests[instrument], reference_results);
+        ASSERT_EQ(results[instrument].size(), reference_results.size());
+        for (size_t i = 0; i < reference_results.size(); ++i)
+        {
+            EXPECT_EQ(results[instrument][i].executed_quantity, reference_results[i].executed_quantity);
+            EXPECT_TRUE(ids.insert(results[instrument][i].id).second);
+        }
+        EXPECT_EQ(manager.book(instrument)->market_data_2_json(), reference_book.market_data_2_json());
+    }
+}
+
+TEST(ORDER_BOOK_MANAGER, Cancel)
+{
+    OrderResult last_result;
+    OrderBookManager<> manager(2, [&](uint32_t, const OrderResult &result) { last_result = result; });
+    manager.add_book(7);
+    EXPECT_TRUE(manager.submit(7, OrderRequest::add(Order::Type::Bid, 100, 5))); // processed after start
+    manager.start();
+    manager.wait_idle();
+    EXPECT_EQ(last_result.status, OrderResult::Status::Rested);
+    EXPECT_NE(last_result.id >> OrderBookBase::id_counter_bits, 0u); // book has own id prefix
+    manager.submit(7, OrderRequest::cancel(last_result.id));
+    manager.wait_idle();
+    EXPECT_EQ(last_result.status, OrderResult::Status::Canceled);
+}
+
+TEST(ORDER_BOOK_MANAGER, FullQueue)
+{
+    size_t result_count = 0;
+    OrderBookManager<> manager(1, [&](uint32_t, const OrderResult &) { ++result_count; }, false, 4);
+    manager.add_book(1);
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(manager.submit(1, OrderRequest::add(Order::Type::Bid, 100, 1)));
+    EXPECT_FALSE(manager.submit(1, OrderRequest::add(Order::Type::Bid, 100, 1))); // workers are stopped
+    manager.start();
+    for (int i = 0; i < 100; ++i) // producer waits for room while workers run
+        EXPECT_TRUE(manager.submit(1, OrderRequest::add(Order::Type::Bid, 100, 1)));
+    manager.wait_idle();
+    manager.stop();
+    EXPECT_EQ(result_count, 104u);
+    EXPECT_EQ(manager.book(1)->best_bid().second.quantity, 104u);
+}
+
+// worker doesn't allocate once books and queues are created, requests of several books share batches
+TEST(ORDER_BOOK_MANAGER, NoAllocationsWhileRunning)
+{
+    size_t result_count = 0;
+    OrderBookManager<> manager(1, [&](uint32_t, const OrderResult &) { ++result_count; }, false);
+    for (uint32_t instrument = 0; instrument < 4; ++instrument)
+        manager.add_book(instrument, PriceBand{900, 1100, 1});
+    manager.start();
+    manager.submit(0, OrderRequest::add(Order::Type::Bid, 1000, 1));
+    manager.wait_idle(); // worker thread has started
+
+    auto allocations = allocation_count();
+    for (int i = 0; i < 20000; ++i)
+    {
+        auto type = i % 2 ? Order::Type::Ask : Order::Type::Bid;
+        ASSERT_TRUE(manager.submit(static_cast<uint32_t>(i / 2 % 4), OrderRequest::add(type, 1000, 1)));
+    }
+    manager.wait_idle();
+    EXPECT_EQ(allocation_count(), allocations);
+    manager.stop();
+    EXPECT_EQ(result_count, 20001u);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "allocation_counter.h"
+#include "order_book.h"
+
+namespace
+{
+// add, cancel and execute orders around the same prices as real flow does, book is empty after each round
+void trade(OrderBook &order_book, int rounds)
+{
+    for (int round = 0; round < rounds; ++round)
+    {
+        Order::IdType ids[100];
+        for (int i = 0; i < 100; ++i)
+        {
+            auto type = i % 2 ? Order::Type::Bid : Order::Type::Ask;
+            auto price = type == Order::Type::Bid ? 990 - i % 10 : 1010 + i % 10;
+            ids[i] = order_book.add_order(type, price, 10);
+        }
+        for (int i = 0; i < 80; ++i)
+            order_book.cancel_order(ids[i]);
+        order_book.add_order(Order::Type::Bid, 1020, 105); // sweep asks, the rest stays in the book
+        order_book.add_order(Order::Type::Ask, 980, 105);
+    }
+}
+
+class CountingResource : public MemoryResource
+{
+public:
+    void *allocate(size_t bytes, size_t alignment) override
+    {
+        allocated += bytes;
+        return MemoryResource::new_delete()->allocate(bytes, alignment);
+    }
+    void deallocate(void *ptr, size_t bytes, size_t alignment) override
+    {
+        MemoryResource::new_delete()->deallocate(ptr, bytes, alignment);
+    }
+    size_t allocated = 0;
+};
+} // namespace
+
+TEST(ORDER_BOOK_MEMORY, NoAllocationsWithinCapacity)
+{
+    Order::QuantityType executed_quantity = 0;
+    OrderBook order_book([&executed_quantity](Order order) { executed_quantity += order.quantity(); });
+    auto allocations = allocation_count();
+    trade(order_book, 100);
+    ASSERT_EQ(allocation_count(), allocations);
+    ASSERT_GT(executed_quantity, 0);
+}
+
+TEST(ORDER_BOOK_MEMORY, NoAllocationsAfterGrowth)
+{
+    OrderBook order_book(nullptr, nullptr, BookMemory{0, 0, nullptr});
+    trade(order_book, 1);
+    auto allocations = allocation_count();
+    trade(order_book, 100);
+    ASSERT_EQ(allocation_count(), allocations);
+}
+
+TEST(ORDER_BOOK_MEMORY, NoAllocationsWithPriceBand)
+{
+    OrderBook order_book(PriceBand{900, 1100, 1});
+    auto allocations = allocation_count();
+    trade(order_book, 100);
+    ASSERT_EQ(allocation_count(), allocations);
+}
+
+TEST(ORDER_BOOK_MEMORY, StorageFromMemoryResource)
+{
+    CountingResource resource;
+    {
+        OrderBook order_book(nullptr, nullptr, BookMemory{100, 10, &resource});
+        ASSERT_GT(resource.allocated, 0);
+        auto allocations = allocation_count();
+        trade(order_book, 10);
+        ASSERT_EQ(allocation_count(), allocations);
+    }
+    ArenaResource arena(1 << 20);
+    OrderBook order_book(nullptr, nullptr, BookMemory{1000, 100, &arena});
+    auto allocations = allocation_count();
+    trade(order_book, 10);
+    ASSERT_EQ(allocation_count(), allocations);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "order_book.h"
+#include "test_book.h"
+
+TEST(ORDER_BOOK_MODIFY, DecreaseKeepsPriority)
+{
+    std::vector<Order> executed_orders;
+    OrderBook order_book([&executed_orders](Order order) { executed_orders.push_back(order); });
+    auto first_id = order_book.add_order(Order::Type::Ask, 1001, 20);
+    auto second_id = order_book.add_order(Order::Type::Ask, 1001, 20);
+    order_book.modify_order(first_id, 1001, 5);
+    ASSERT_EQ(order_book.get_order(first_id).quantity(), 5);
+    order_book.add_order(Order::Type::Bid, 1001, 10);
+    ASSERT_EQ(executed_orders.size(), 4);
+    ASSERT_EQ(executed_orders[0].id(), first_id);
+    ASSERT_EQ(executed_orders[0].quantity(), 5);
+    ASSERT_EQ(executed_orders[2].id(), second_id);
+    ASSERT_EQ(order_book.get_order(second_id).quantity(), 15);
+}
+
+TEST(ORDER_BOOK_MODIFY, IncreaseLosesPriority)
+{
+    std::vector<Order> executed_orders;
+    OrderBook order_book([&executed_orders](Order order) { executed_orders.push_back(order); });
+    auto first_id = order_book.add_order(Order::Type::Ask, 1001, 20);
+    auto second_id = order_book.add_order(Order::Type::Ask, 1001, 20);
+    order_book.modify_order(first_id, 1001, 25);
+    order_book.add_order(Order::Type::Bid, 1001, 10);
+    ASSERT_EQ(executed_orders[0].id(), second_id);
+    ASSERT_EQ(order_book.get_order(first_id).quantity(), 25);
+}
+
+TEST(ORDER_BOOK_MODIFY, PriceChangeExecutes)
+{
+    std::vector<Order> executed_orders;
+    std::vector<Order> canceled_orders;
+    OrderBook order_book = test_order_book([&executed_orders](Order order) { executed_orders.push_back(order); },
+                                           [&canceled_orders](Order order) { canceled_orders.push_back(order); });
+    auto id = order_book.add_order(Order::Type::Bid, 950, 45);
+    order_book.modify_order(id, 1002, 45);
+    ASSERT_EQ(executed_orders.size(), 6);
+    ASSERT_EQ(executed_orders[5].id(), id);
+    ASSERT_EQ(order_book.market_data_2_json(), R"V({
+    "best_ask": {
+        "price": 1002,
+        "quantity": 15
+    },
+    "best_bid": {
+        "price": 999,
+        "quantity": 40
+    },
+    "last_transaction": {
+        "price": 1002,
+        "quantity": 15
+    },
+    "asks": [
+        {
+            "price": 1002,
+            "quantity": 15
+        },
+        {
+            "price": 1003,
+            "quantity": 90
+        }
+    ],
+    "bids": [
+        {
+            "price": 999,
+            "quantity": 40
+        },
+        {
+            "price": 900,
+            "quantity": 79
+        },
+        {
+            "price": 800,
+            "quantity": 55
+        }
+    ]
+}
+)V");
+    ASSERT_THROW(order_book.get_order(id), OrderBook::NotFoundException);
+    ASSERT_TRUE(canceled_orders.empty());
+}
+
+TEST(ORDER_BOOK_MODIFY, Errors)
+{
+    std::vector<Order> canceled_orders;
+    OrderBook order_book(PriceBand{900, 1100, 1}, nullptr, [&canceled_orders](Order order) { canceled_orders.push_back(order); });
+    auto id = order_book.add_order(Order::Type::Bid, 950, 45);
+    ASSERT_THROW(order_book.modify_order(id + 1, 950, 10), OrderBook::NotFoundException);
+    ASSERT_THROW(order_book.modify_order(id, 1200, 10), OrderBook::OutOfBandException);
+    ASSERT_EQ(order_book.get_order(id).quantity(), 45);
+    order_book.modify_order(id, 950, 0);
+    ASSERT_EQ(canceled_orders.size(), 1);
+    ASSERT_THROW(order_book.get_order(id), OrderBook::NotFoundException);
+}
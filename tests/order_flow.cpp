@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <unistd.h>
+#include <vector>
+#include "latency_histogram.hpp"
+#include "order_book.h"
+#include "order_flow.h"
+
+namespace
+{
+std::vector<FlowEvent> generate_flow(const FlowConfig &config, size_t count)
+{
+    OrderFlowGenerator generator(config);
+    std::vector<FlowEvent> events(count);
+    generator.generate(events);
+    return events;
+}
+
+bool same_flow(const std::vector<FlowEvent> &a, const std::vector<FlowEvent> &b)
+{
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        const auto &x = a[i].request;
+        const auto &y = b[i].request;
+        if (a[i].time != b[i].time || x.action != y.action || x.type != y.type || x.id != y.id || x.price != y.price ||
+            x.quantity != y.quantity)
+            return false;
+    }
+    return true;
+}
+} // namespace
+
+TEST(ORDER_FLOW, Deterministic)
+{
+    FlowConfig config;
+    config.seed = 7;
+    auto flow = generate_flow(config, 10000);
+    EXPECT_TRUE(same_flow(flow, generate_flow(config, 10000)));
+    config.seed = 8;
+    EXPECT_FALSE(same_flow(flow, generate_flow(config, 10000)));
+    for (size_t i = 1; i < flow.size(); ++i)
+        ASSERT_LE(flow[i - 1].time, flow[i].time);
+}
+
+TEST(ORDER_FLOW, ReplayFindsOrders)
+{
+    FlowConfig config;
+    config.resting_orders = 500;
+    config.sweep_probability = 0.01;
+    OrderFlowGenerator generator(config);
+    std::vector<FlowEvent> events(100000);
+    generator.generate(events);
+
+    auto margin = config.mid_drift_limit + config.max_offset + config.sweep_levels;
+    OrderBook order_book(PriceBand{config.mid_price - margin, config.mid_price + margin, 1});
+    order_book.set_id_block(generator.ids());
+    size_t cancels = 0;
+    size_t trades = 0;
+    for (const auto &event : events)
+    {
+        OrderResult result;
+        order_book.add_orders(Span<const OrderRequest>(&event.request, 1), Span<OrderResult>(&result, 1));
+        ASSERT_NE(result.status, OrderResult::Status::NotFound);
+        ASSERT_NE(result.status, OrderResult::Status::Rejected);
+        cancels += result.status == OrderResult::Status::Canceled;
+        trades += result.trade_count;
+    }
+    EXPECT_GT(cancels, events.size() * 3 / 10);
+    EXPECT_LT(cancels, events.size() / 2);
+    EXPECT_GT(trades, 0u);
+}
+
+TEST(ORDER_FLOW, ReadCsv)
+{
+    auto path = testing::TempDir() + "flow.csv";
+    {
+        std::ofstream file(path);
+        file << "# recorded flow\n0,A,B,1000,10\n5,A,S,1001,7\n\n9,M,1,999,4\n12,C,2\n";
+    }
+    auto events = read_flow_csv(path);
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events[1].time, 5u);
+    EXPECT_EQ(events[1].request.type, Order::Type::Ask);
+    EXPECT_EQ(events[1].request.price, 1001);
+    EXPECT_EQ(events[2].request.action, OrderRequest::Action::Modify);
+    EXPECT_EQ(events[2].request.quantity, 4u);
+    EXPECT_EQ(events[3].request.action, OrderRequest::Action::Cancel);
+    EXPECT_EQ(events[3].request.id, 2u);
+
+    {
+        std::ofstream file(path);
+        file << "0,A,B,1000,10\n1,X,1\n";
+    }
+    EXPECT_THROW(read_flow_csv(path), OrderBookBase::Exception);
+    unlink(path.c_str());
+}
+
+TEST(LATENCY_HISTOGRAM, Percentiles)
+{
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.percentile(50), 0u);
+    for (uint64_t value = 1; value <= 100000; ++value)
+        histogram.record(value);
+    histogram.record(1000000000);
+    EXPECT_EQ(histogram.count(), 100001u);
+    EXPECT_EQ(histogram.max(), 1000000000u);
+    EXPECT_EQ(histogram.percentile(100), 1000000000u);
+    for (auto percent : {1.0, 50.0, 99.0, 99.9})
+    {
+        auto expected = static_cast<double>(percent * 1000);
+        EXPECT_NEAR(static_cast<double>(histogram.percentile(percent)), expected, expected / 64 + 1);
+    }
+    histogram.reset();
+    histogram.record(42);
+    EXPECT_EQ(histogram.percentile(50), 42u);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <thread>
+#include <vector>
+#include "order_pipeline.hpp"
+
+TEST(ORDER_PIPELINE, SameAsBook)
+{
+    BasicOrderBook<NullListener> order_book, reference_book;
+    OrderPipeline<NullListener, SpscRing<OrderCommand>> pipeline(order_book, 256, 256, 16);
+    pipeline.start();
+
+    std::mt19937 random(5);
+    std::vector<OrderRequest> requests;
+    for (int i = 0; i < 10000; ++i)
+    {
+        auto type = random() % 2 ? Order::Type::Ask : Order::Type::Bid;
+        requests.push_back(OrderRequest::add(type, 990 + random() % 20, 1 + random() % 10));
+    }
+    std::vector<PipelineResult> results;
+    std::thread gateway([&] {
+        for (size_t i = 0; i < requests.size(); ++i)
+        {
+            while (!pipeline.submit(requests[i], i))
+                std::this_thread::yield();
+        }
+    });
+    PipelineResult buffer[32];
+    while (results.size() < requests.size())
+    {
+        auto count = pipeline.poll(buffer);
+        if (count == 0)
+            std::this_thread::yield();
+        results.insert(results.end(), buffer, buffer + count);
+    }
+    gateway.join();
+    pipeline.stop();
+
+    std::vector<OrderResult> reference_results(requests.size());
+    reference_book.add_orders(requests, reference_results);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        EXPECT_EQ(results[i].tag, i);
+        EXPECT_EQ(results[i].result.executed_quantity, reference_results[i].executed_quantity);
+        EXPECT_LE(results[i].submit_time, results[i].dequeue_time);
+        EXPECT_LE(results[i].dequeue_time, results[i].done_time);
+    }
+    EXPECT_EQ(order_book.market_data_2_json(), reference_book.market_data_2_json());
+}
+
+TEST(ORDER_PIPELINE, ManyGateways)
+{
+    BasicOrderBook<NullListener> order_book;
+    OrderPipeline<> pipeline(order_book, 64, 64);
+    pipeline.start();
+    const size_t gateway_count = 3, order_count = 5000;
+    std::vector<std::thread> gateways;
+    for (size_t gateway = 0; gateway < gateway_count; ++gateway)
+    {
+        gateways.emplace_back([&pipeline, gateway] {
+            for (size_t i = 0; i < order_count; ++i)
+            {
+                while (!pipeline.submit(OrderRequest::add(Order::Type::Bid, 100, 1), gateway))
+                    std::this_thread::yield();
+            }
+        });
+    }
+    std::vector<size_t> received(gateway_count, 0);
+    PipelineResult buffer[32];
+    for (size_t total = 0; total < gateway_count * order_count;)
+    {
+        auto count = pipeline.poll(buffer);
+        if (count == 0)
+            std::this_thread::yield();
+        for (size_t i = 0; i < count; ++i)
+        {
+            ASSERT_LT(buffer[i].tag, gateway_count);
+            ++received[buffer[i].tag];
+            EXPECT_EQ(buffer[i].result.status, OrderResult::Status::Rested);
+        }
+        total += count;
+    }
+    for (auto &gateway : gateways)
+        gateway.join();
+    pipeline.stop();
+    EXPECT_EQ(received, std::vector<size_t>(gateway_count, order_count));
+    EXPECT_EQ(order_book.best_bid().second.order_count, gateway_count * order_count);
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "ring_buffer.hpp"
+
+namespace
+{
+// producers push increasing values tagged with producer number, consumer checks order of each producer
+template <typename Ring>
+void check_ring(size_t producer_count)
+{
+    const uint64_t count = 20000;
+    Ring ring(64);
+    std::vector<std::thread> producers;
+    for (uint64_t producer = 0; producer < producer_count; ++producer)
+    {
+        producers.emplace_back([&ring, producer, count] {
+            for (uint64_t i = 0; i < count; ++i)
+            {
+                while (!ring.try_push(producer << 32 | i))
+                    std::this_thread::yield();
+            }
+        });
+    }
+    std::vector<uint64_t> next(producer_count, 0);
+    uint64_t items[16];
+    for (uint64_t received = 0; received < count * producer_count;)
+    {
+        auto taken = ring.pop(items, 16);
+        if (taken == 0)
+            std::this_thread::yield();
+        for (size_t i = 0; i < taken; ++i)
+        {
+            auto producer = items[i] >> 32;
+            ASSERT_LT(producer, producer_count);
+            ASSERT_EQ(items[i] & 0xffffffff, next[producer]++);
+        }
+        received += taken;
+    }
+    for (auto &producer : producers)
+        producer.join();
+    EXPECT_FALSE(ring.try_pop(items[0]));
+}
+} // namespace
+
+TEST(RING_BUFFER, Capacity)
+{
+    SpscRing<int> ring(5);
+    EXPECT_EQ(ring.capacity(), 8u);
+    for (int i = 0; i < 8; ++i)
+        EXPECT_TRUE(ring.try_push(i));
+    EXPECT_FALSE(ring.try_push(8));
+    int item;
+    EXPECT_TRUE(ring.try_pop(item));
+    EXPECT_EQ(item, 0);
+    EXPECT_TRUE(ring.try_push(8));
+
+    MpscRing<int> mpsc_ring(4);
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(mpsc_ring.try_push(i));
+    EXPECT_FALSE(mpsc_ring.try_push(4));
+}
+
+TEST(RING_BUFFER, Spsc)
+{
+    check_ring<SpscRing<uint64_t>>(1);
+}
+
+TEST(RING_BUFFER, Mpsc)
+{
+    check_ring<MpscRing<uint64_t>>(4);
+}
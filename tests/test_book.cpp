@@ -1,9 +1,9 @@
 #include "test_book.h"
 
-OrderBook test_order_book(OrderBook::OrderCallback executed_order_callback /*= nullptr*/
-    , OrderBook::OrderCallback canceled_order_callback /*= nullptr*/)
+#include <array>
+
+static void add_test_orders(OrderBook &order_book)
 {
-    OrderBook order_book(executed_order_callback, canceled_order_callback);
     std::array<Data, 10> orders =
         {
             Data{Order::Type::Ask, 1003, 50},
@@ -21,5 +21,20 @@ OrderBook test_order_book(OrderBook::OrderCallback executed_order_callback /*= n
     {
         order_book.add_order(order.type, order.price, order.quantity);
     }
+}
+
+OrderBook test_order_book(OrderBook::OrderCallback executed_order_callback /*= nullptr*/
+    , OrderBook::OrderCallback canceled_order_callback /*= nullptr*/)
+{
+    OrderBook order_book(executed_order_callback, canceled_order_callback);
+    add_test_orders(order_book);
+    return order_book;
+}
+
+OrderBook test_order_book(const PriceBand &band, OrderBook::OrderCallback executed_order_callback /*= nullptr*/
+    , OrderBook::OrderCallback canceled_order_callback /*= nullptr*/)
+{
+    OrderBook order_book(band, executed_order_callback, canceled_order_callback);
+    add_test_orders(order_book);
     return order_book;
 }
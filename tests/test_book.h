@@ -11,3 +11,6 @@ struct Data
 
 OrderBook test_order_book(OrderBook::OrderCallback executed_order_callback = nullptr
 , OrderBook::OrderCallback canceled_order_callback = nullptr);
+
+OrderBook test_order_book(const PriceBand &band, OrderBook::OrderCallback executed_order_callback = nullptr
+, OrderBook::OrderCallback canceled_order_callback = nullptr);
@@ -0,0 +1,206 @@
+// Replays synthetic or recorded order flow through OrderBook and reports throughput and latency
+// percentiles of each operation type.
+//
+//     order_flow_replay [--count=N] [--seed=N] [--rate=N] [--cancel-ratio=X] [--resting-orders=N]
+//                       [--modify-ratio=X] [--aggressive-ratio=X] [--sweep-probability=X]
+//                       [--offset-exponent=X] [--max-offset=N] [--band] [--paced]
+//                       [--csv=FILE [--first-id=N]] [--journal=FILE]
+//
+// Flow is generated by OrderFlowGenerator unless --csv or --journal file is given. --band replays into book
+// with dense price levels around the mid price of generated flow, --paced waits for arrival time of each request.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "journal.h"
+#include "latency_histogram.hpp"
+#include "order_book.h"
+#include "order_flow.h"
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct Options
+{
+    FlowConfig flow;
+    size_t count = 1000000;
+    bool band = false;
+    bool paced = false;
+    std::string csv;
+    std::string journal;
+    Order::IdType first_id = 1;
+};
+
+bool parse_option(const char *arg, const char *name, std::string &value)
+{
+    auto length = std::strlen(name);
+    if (std::strncmp(arg, name, length) != 0 || arg[length] != '=')
+        return false;
+    value = arg + length + 1;
+    return true;
+}
+
+Options parse_options(int argc, char **argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string value;
+        if (parse_option(argv[i], "--count", value))
+            options.count = std::stoull(value);
+        else if (parse_option(argv[i], "--seed", value))
+            options.flow.seed = std::stoull(value);
+        else if (parse_option(argv[i], "--rate", value))
+            options.flow.arrival_rate = std::stod(value);
+        else if (parse_option(argv[i], "--cancel-ratio", value))
+            options.flow.cancel_ratio = std::stod(value);
+        else if (parse_option(argv[i], "--resting-orders", value))
+            options.flow.resting_orders = std::stoull(value);
+        else if (parse_option(argv[i], "--modify-ratio", value))
+            options.flow.modify_ratio = std::stod(value);
+        else if (parse_option(argv[i], "--aggressive-ratio", value))
+            options.flow.aggressive_ratio = std::stod(value);
+        else if (parse_option(argv[i], "--sweep-probability", value))
+            options.flow.sweep_probability = std::stod(value);
+        else if (parse_option(argv[i], "--offset-exponent", value))
+            options.flow.offset_exponent = std::stod(value);
+        else if (parse_option(argv[i], "--max-offset", value))
+            options.flow.max_offset = std::stoi(value);
+        else if (parse_option(argv[i], "--csv", value))
+            options.csv = value;
+        else if (parse_option(argv[i], "--journal", value))
+            options.journal = value;
+        else if (parse_option(argv[i], "--first-id", value))
+            options.first_id = std::stoull(value);
+        else if (std::strcmp(argv[i], "--band") == 0)
+            options.band = true;
+        else if (std::strcmp(argv[i], "--paced") == 0)
+            options.paced = true;
+        else
+            throw std::invalid_argument(std::string("unknown option ") + argv[i]);
+    }
+    return options;
+}
+
+std::vector<FlowEvent> load_flow(const Options &options, IdBlock &ids)
+{
+    if (!options.csv.empty())
+    {
+        ids = IdBlock{options.first_id, std::numeric_limits<Order::IdType>::max()};
+        return read_flow_csv(options.csv);
+    }
+    std::vector<FlowEvent> events;
+    if (!options.journal.empty())
+    {
+        JournalReader reader(options.journal);
+        ids = reader.ids();
+        std::vector<OrderRequest> requests(4096);
+        for (auto count = reader.read(requests); count > 0; count = reader.read(requests))
+        {
+            for (size_t i = 0; i < count; ++i)
+                events.push_back(FlowEvent{0, requests[i]});
+        }
+        return events;
+    }
+    OrderFlowGenerator generator(options.flow);
+    ids = generator.ids();
+    events.resize(options.count);
+    generator.generate(events);
+    return events;
+}
+
+enum Operation
+{
+    Add,      // add which rested without trades
+    AddTrade, // add which executed against the book
+    Cancel,
+    Modify,
+    NotFound, // cancel or modify of order not in the book
+    Rejected,
+    OperationCount
+};
+
+const char *operation_names[OperationCount] = {"add", "add+trade", "cancel", "modify", "not found", "rejected"};
+
+Operation operation(const OrderRequest &request, const OrderResult &result)
+{
+    if (result.status == OrderResult::Status::Rejected)
+        return Rejected;
+    if (result.status == OrderResult::Status::NotFound)
+        return NotFound;
+    if (request.action == OrderRequest::Action::Add)
+        return result.trade_count > 0 ? AddTrade : Add;
+    return request.action == OrderRequest::Action::Cancel ? Cancel : Modify;
+}
+
+void print_histogram(const char *name, const LatencyHistogram &histogram, double seconds)
+{
+    if (histogram.count() == 0)
+        return;
+    std::printf("%-10s %10llu %12.0f %8llu %8llu %8llu %10llu\n", name,
+                static_cast<unsigned long long>(histogram.count()), static_cast<double>(histogram.count()) / seconds,
+                static_cast<unsigned long long>(histogram.percentile(50)),
+                static_cast<unsigned long long>(histogram.percentile(99)),
+                static_cast<unsigned long long>(histogram.percentile(99.9)),
+                static_cast<unsigned long long>(histogram.max()));
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    std::vector<FlowEvent> events;
+    IdBlock ids;
+    try
+    {
+        options = parse_options(argc, argv);
+        events = load_flow(options, ids);
+    }
+    catch (const std::exception &e)
+    {
+        std::fprintf(stderr, "order_flow_replay: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    auto band_margin = options.flow.mid_drift_limit + options.flow.max_offset + options.flow.sweep_levels;
+    OrderBook order_book = options.band ? OrderBook(PriceBand{options.flow.mid_price - band_margin,
+                                                              options.flow.mid_price + band_margin, 1})
+                                        : OrderBook();
+    order_book.set_id_block(ids);
+
+    LatencyHistogram histograms[OperationCount];
+    LatencyHistogram all;
+    OrderResult result;
+    auto start = Clock::now();
+    for (const auto &event : events)
+    {
+        if (options.paced)
+        {
+            while (Clock::now() - start < std::chrono::nanoseconds(event.time))
+            {
+            }
+        }
+        auto before = Clock::now();
+        order_book.add_orders(Span<const OrderRequest>(&event.request, 1), Span<OrderResult>(&result, 1));
+        auto latency = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - before).count());
+        histograms[operation(event.request, result)].record(latency);
+        all.record(latency);
+    }
+    auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::printf("%zu requests in %.3f s, %.0f requests/s, %zu bid and %zu ask levels left\n", events.size(), seconds,
+                static_cast<double>(events.size()) / seconds, order_book.level_count(Order::Type::Bid),
+                order_book.level_count(Order::Type::Ask));
+    std::printf("%-10s %10s %12s %8s %8s %8s %10s\n", "operation", "count", "per second", "p50 ns", "p99 ns",
+                "p99.9 ns", "max ns");
+    for (int i = 0; i < OperationCount; ++i)
+        print_histogram(operation_names[i], histograms[i], seconds);
+    print_histogram("all", all, seconds);
+    return EXIT_SUCCESS;
+}